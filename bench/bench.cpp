@@ -0,0 +1,241 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file bench.cpp
+ * @brief Times every engine on the instances of etc/datasets.csv in a single process
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * A line of the datasets is "type; number; i_0; ...; i_m; z", where the type 'A' runs all engines,
+ * and 'F' skips the naive one. Each engine is run -warmup times untimed and -repetitions times timed.
+ * The answers of all engines on an instance have to agree, otherwise the exit code is 1.
+ *
+ * With -scaling, it instead runs generateParallelIntervalPartition with 1 and each of -threads threads,
+ * and writes per instance and thread count a CSV line with speedup and parallel efficiency,
+ * together with the total work and the critical path of the jobs measured by a single-threaded run.
+ */
+
+#include "common.hpp"
+#include "naive.hpp"
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+DEFINE_string(datasets, DATASETS_CSV, "The instances to run");
+DEFINE_string(rows, "", "Comma-separated numbers of the instances to run, all if empty");
+DEFINE_string(threads, "", "Comma-separated thread counts of the parallel engine, 2 up to the number of cores if empty");
+DEFINE_bool(naive, true, "Run the naive engine on the instances of type A");
+DEFINE_uint64(warmup, 1, "Untimed runs before the timed ones");
+DEFINE_uint64(repetitions, 5, "Timed runs of each engine on each instance");
+DEFINE_double(budget, 60, "Stop repeating an engine on an instance after this many seconds");
+DEFINE_string(json, "", "Write the results as JSON to this file");
+DEFINE_bool(scaling, false, "Report the scaling of the parallel engine with the number of threads as CSV");
+DEFINE_string(csv, "", "With -scaling, write the CSV to this file instead of stdout");
+
+namespace gflags {}
+namespace google {}
+
+namespace {
+
+	using Bench::Instance;
+	using Bench::parseList;
+	using Bench::readDatasets;
+
+	struct Engine {
+		std::string name;
+		size_t threads;
+	};
+
+	/** The summary of the timed runs of an engine on an instance */
+	struct Sample {
+		const Instance* instance;
+		Engine engine;
+		std::vector<double> wall; //!< seconds
+		std::vector<double> cpu; //!< seconds of all threads of the process
+		Z result;
+		bool agrees;
+	};
+
+	Z run(const Engine& engine, const Instance& instance) {
+		if(engine.name == "naive") return naive_bounds<Z>(instance.bounds.data(), instance.z, 0, instance.bounds.size()-1);
+		return IntervalPartition::number_of_interval_partitions(instance.bounds.data(), instance.bounds.size(), instance.z, engine.threads);
+	}
+
+	/** @return the value at the given fraction of the sorted values, by the nearest-rank method */
+	double quantile(std::vector<double> values, const double fraction) {
+		std::sort(values.begin(), values.end());
+		const size_t rank = static_cast<size_t>(std::ceil(fraction * values.size()));
+		return values[rank == 0 ? 0 : rank-1];
+	}
+
+	void jsonTimes(std::ostream& os, const std::vector<double>& times) {
+		os << "{\"min\": " << quantile(times, 0) << ", \"median\": " << quantile(times, 0.5) << ", \"p95\": " << quantile(times, 0.95) << "}";
+	}
+
+	void json(std::ostream& os, const std::vector<Sample>& samples) {
+		os << "[";
+		for(size_t s = 0; s < samples.size(); ++s) {
+			const Sample& sample = samples[s];
+			os << (s > 0 ? "," : "") << "\n{\"number\": " << sample.instance->number << ", \"type\": \"" << sample.instance->type << "\", \"bounds\": [";
+			for(size_t i = 0; i < sample.instance->bounds.size(); ++i) os << (i > 0 ? ", " : "") << sample.instance->bounds[i];
+			os << "], \"z\": " << sample.instance->z << ", \"engine\": \"" << sample.engine.name << "\", \"threads\": " << sample.engine.threads
+				<< ", \"repetitions\": " << sample.wall.size() << ", \"wall\": ";
+			jsonTimes(os, sample.wall);
+			os << ", \"cpu\": ";
+			jsonTimes(os, sample.cpu);
+			os << ", \"result\": \"" << sample.result << "\", \"agrees\": " << (sample.agrees ? "true" : "false") << "}";
+		}
+		os << "\n]\n";
+	}
+
+	double seconds(const std::function<void()>& f) {
+		const auto timeA = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - timeA).count();
+	}
+
+	/**
+	 * Writes for each thread count the speedup and efficiency of the parallel engine wrt. one thread.
+	 * The critical path is the longest chain of dependent jobs of a single-threaded run, such that
+	 * work / critical path bounds the speedup that the dependencies between the levels admit.
+	 */
+	void scaling(std::ostream& os, const Instance& instance, const std::vector<size_t>& threadCounts) {
+		std::vector<unsigned int> bounds; // as number_of_interval_partitions, sweep over the bounds larger than one
+		for(const unsigned int bound : instance.bounds) {
+			if(bound == 0) return;
+			if(bound > 1) bounds.push_back(bound);
+		}
+		if(bounds.empty()) return;
+		const IntervalPartition::SweepPlan plan(bounds.data(), bounds.size(), true);
+		for(size_t i = 0; i < FLAGS_warmup; ++i) IntervalPartition::generateParallelIntervalPartition(plan, 1);
+
+		vektor<vektor<double>> jobSeconds;
+		IntervalPartition::generateParallelIntervalPartition(plan, 1, &jobSeconds);
+		double work = 0;
+		for(const auto& level : jobSeconds) for(const double job : level) work += job;
+		const double criticalPath = plan.criticalPath(jobSeconds);
+
+		std::vector<size_t> counts(1, 1);
+		for(const size_t threads : threadCounts) if(threads > 1) counts.push_back(threads);
+		double baseline = 0;
+		for(const size_t threads : counts) {
+			std::vector<double> wall;
+			double spent = 0;
+			for(size_t i = 0; i < std::max<size_t>(1, FLAGS_repetitions) && (i == 0 || spent < FLAGS_budget); ++i) {
+				wall.push_back(seconds([&] () { IntervalPartition::generateParallelIntervalPartition(plan, threads); }));
+				spent += wall.back();
+			}
+			const double median = quantile(wall, 0.5);
+			if(threads == 1) baseline = median;
+			const double speedup = baseline / median;
+			os << instance.number << "," << threads << "," << median << "," << speedup << "," << speedup / threads << ","
+				<< work << "," << criticalPath << "," << work / criticalPath << std::endl;
+		}
+	}
+
+}//ns
+
+int main(int argc, char** argv) {
+	{
+		using namespace google;
+		using namespace gflags;
+		ParseCommandLineFlags(&argc, &argv, true);
+	}
+	std::ifstream file(FLAGS_datasets);
+	if(!file) {
+		std::cerr << "Could not open " << FLAGS_datasets << std::endl;
+		return 1;
+	}
+	const std::vector<Instance> instances = readDatasets(file);
+	const std::vector<size_t> rows = parseList(FLAGS_rows);
+	std::vector<size_t> threadCounts = parseList(FLAGS_threads);
+	if(FLAGS_threads.empty()) {
+		for(size_t t = 2; t <= std::thread::hardware_concurrency(); ++t) threadCounts.push_back(t);
+	}
+
+	if(FLAGS_scaling) {
+		std::ofstream csvFile;
+		if(!FLAGS_csv.empty()) csvFile.open(FLAGS_csv);
+		std::ostream& csv = FLAGS_csv.empty() ? std::cout : csvFile;
+		csv << "number,threads,wall_median,speedup,efficiency,work,critical_path,parallelism" << std::endl;
+		for(const Instance& instance : instances) {
+			if(!rows.empty() && std::find(rows.begin(), rows.end(), instance.number) == rows.end()) continue;
+			scaling(csv, instance, threadCounts);
+		}
+		if(!csv) {
+			std::cerr << "Could not write " << FLAGS_csv << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	std::vector<Sample> samples;
+	bool agreeing = true;
+	std::cout << "# number engine threads repetitions wall_min wall_median wall_p95 cpu_median" << std::endl;
+	for(const Instance& instance : instances) {
+		if(!rows.empty() && std::find(rows.begin(), rows.end(), instance.number) == rows.end()) continue;
+		std::vector<Engine> engines;
+		if(FLAGS_naive && instance.type == 'A') engines.push_back(Engine { "naive", 1 });
+		engines.push_back(Engine { "sequential", 1 });
+		for(const size_t threads : threadCounts) engines.push_back(Engine { "parallel", threads });
+
+		const size_t first = samples.size();
+		for(const Engine& engine : engines) {
+			Sample sample { &instance, engine, {}, {}, 0, true };
+			for(size_t i = 0; i < FLAGS_warmup; ++i) sample.result = run(engine, instance);
+			double spent = 0;
+			for(size_t i = 0; i < std::max<size_t>(1, FLAGS_repetitions) && (i == 0 || spent < FLAGS_budget); ++i) {
+				const auto wallA = std::chrono::steady_clock::now();
+				const std::clock_t cpuA = std::clock();
+				sample.result = run(engine, instance);
+				const std::clock_t cpuB = std::clock();
+				const auto wallB = std::chrono::steady_clock::now();
+				sample.wall.push_back(std::chrono::duration<double>(wallB - wallA).count());
+				sample.cpu.push_back(static_cast<double>(cpuB - cpuA) / CLOCKS_PER_SEC);
+				spent += sample.wall.back();
+			}
+			samples.push_back(sample);
+		}
+		for(size_t s = first; s < samples.size(); ++s) {
+			Sample& sample = samples[s];
+			sample.agrees = sample.result == samples[first].result;
+			agreeing &= sample.agrees;
+			std::cout << instance.number << " " << sample.engine.name << " " << sample.engine.threads << " " << sample.wall.size() << " "
+				<< quantile(sample.wall, 0) << " " << quantile(sample.wall, 0.5) << " " << quantile(sample.wall, 0.95) << " " << quantile(sample.cpu, 0.5);
+			if(!sample.agrees) std::cout << " MISMATCH " << sample.result << " vs " << samples[first].engine.name << " " << samples[first].result;
+			std::cout << std::endl;
+		}
+	}
+
+	if(!FLAGS_json.empty()) {
+		std::ofstream output(FLAGS_json);
+		json(output, samples);
+		if(!output) {
+			std::cerr << "Could not write " << FLAGS_json << std::endl;
+			return 1;
+		}
+	}
+	return agreeing ? 0 : 1;
+}
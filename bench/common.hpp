@@ -0,0 +1,104 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file common.hpp
+ * @brief The instances and inputs shared by the benchmark executables
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef BENCH_COMMON_HPP
+#define BENCH_COMMON_HPP
+
+#include "interval_partition.hpp"
+#include "sum_from_zero_cacher.hpp"
+#include <algorithm>
+#include <istream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef DATASETS_CSV
+#define DATASETS_CSV "etc/datasets.csv"
+#endif
+
+namespace Bench {
+
+	struct Instance {
+		char type;
+		size_t number;
+		std::vector<unsigned int> bounds;
+		unsigned long z;
+	};
+
+	inline std::vector<size_t> parseList(const std::string& list) {
+		std::vector<size_t> ret;
+		std::istringstream ss(list);
+		for(std::string item; std::getline(ss, item, ',');) {
+			if(!item.empty()) ret.push_back(std::stoul(item));
+		}
+		return ret;
+	}
+
+	/**
+	 * Reads the lines "type; number; i_0; ...; i_m; z" of etc/datasets.csv, where the type is 'A' or 'F'
+	 */
+	inline std::vector<Instance> readDatasets(std::istream& input) {
+		std::vector<Instance> instances;
+		for(std::string line; std::getline(input, line);) {
+			if(line.empty() || line[0] == '#') continue;
+			std::vector<std::string> fields;
+			std::istringstream ss(line);
+			for(std::string field; std::getline(ss, field, ';');) fields.push_back(field);
+			if(fields.size() < 4) continue;
+			Instance instance;
+			instance.type = fields[0].find('F') == std::string::npos ? 'A' : 'F';
+			instance.number = std::stoul(fields[1]);
+			for(size_t i = 2; i+1 < fields.size(); ++i) instance.bounds.push_back(std::stoul(fields[i]));
+			instance.z = std::stoul(fields.back());
+			instances.push_back(instance);
+		}
+		return instances;
+	}
+
+	/** The input and the levels of a sweep, where level k consists of pieces of degree k */
+	struct Sweep {
+		vektor<unsigned int> bounds;
+		vektor<IntervalPartition::IntervalledPolynom> levels;
+	};
+
+	/**
+	 * Sweeps over degree+1 bounds drawn uniformly from [magnitude/2, magnitude]
+	 */
+	template<class t_Generator>
+	Sweep sweep(const size_t magnitude, const size_t degree, t_Generator& generator) {
+		std::uniform_int_distribution<unsigned int> distribution(std::max<size_t>(2, magnitude/2), std::max<size_t>(2, magnitude));
+		Sweep ret;
+		ret.bounds.resize(degree+1);
+		for(auto& bound : ret.bounds) bound = distribution(generator);
+		const IntervalPartition::SweepPlan plan(ret.bounds.data(), ret.bounds.size(), false);
+		IntervalPartition::SumFromZeroCacher sumcacher;
+		IntervalPartition::generateIntervalPartition(plan, sumcacher, &ret.levels);
+		return ret;
+	}
+
+}//ns
+
+#endif//guard
@@ -0,0 +1,160 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file kernels.cpp
+ * @brief Times the polynomial kernels of the sweep in isolation
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * The inputs are the pieces of a real sweep: for each magnitude m of -magnitudes, the bounds are drawn from [m/2, m],
+ * and level k of the sweep yields the pieces of degree k. The magnitude controls the bit size of the coefficients.
+ * Every kernel is called on all pieces of a level in turn, until -min_seconds have passed; this is repeated -repetitions times.
+ * The output is CSV with the median and minimum time per call in nanoseconds.
+ */
+
+#include "common.hpp"
+#include "binomial.hpp"
+#include "sum_from_zero_to_upper.hpp"
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <sstream>
+
+DEFINE_string(magnitudes, "10,1000,100000", "Comma-separated magnitudes of the bounds");
+DEFINE_uint64(degree, 12, "The largest degree of a piece, i.e., the number of bounds minus one");
+DEFINE_double(min_seconds, 0.02, "Minimal time of a repetition");
+DEFINE_uint64(repetitions, 5, "Repetitions of each measurement");
+DEFINE_string(kernels, "", "Comma-separated kernels to run, all if empty");
+
+namespace gflags {}
+namespace google {}
+
+namespace {
+	using namespace IntervalPartition;
+
+	volatile size_t sink; //!< receives a value of every call such that it is not optimized away
+
+	/** @return the average number of bits of the numerators and denominators of the coefficients */
+	double averageBits(const IntervalledPolynom& level) {
+		double bits = 0;
+		size_t count = 0;
+		for(const Polynom& p : level.polynomials()) {
+			for(const Q& coeff : p) {
+				bits += mpz_sizeinbase(coeff.get_num_mpz_t(), 2) + mpz_sizeinbase(coeff.get_den_mpz_t(), 2);
+				++count;
+			}
+		}
+		return count == 0 ? 0 : bits / count;
+	}
+
+	/**
+	 * Calls kernel(i) for i = 0, 1, ..., pieces-1, 0, 1, ... until min_seconds have passed
+	 * @return the time per call in nanoseconds
+	 */
+	double measure(const size_t pieces, const std::function<void(size_t)>& kernel) {
+		size_t calls = 0;
+		const auto timeA = std::chrono::steady_clock::now();
+		double elapsed = 0;
+		do {
+			for(size_t i = 0; i < pieces; ++i) kernel(i);
+			calls += pieces;
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeA).count();
+		} while(elapsed < FLAGS_min_seconds);
+		return elapsed * 1e9 / calls;
+	}
+
+	void report(const std::string& kernel, const size_t magnitude, const size_t degree, const double bits, const size_t pieces, const std::function<void(size_t)>& f) {
+		std::vector<double> nanos;
+		for(size_t r = 0; r < std::max<size_t>(1, FLAGS_repetitions); ++r) nanos.push_back(measure(pieces, f));
+		std::sort(nanos.begin(), nanos.end());
+		std::cout << kernel << "," << magnitude << "," << degree << "," << bits << "," << pieces << ","
+			<< nanos[nanos.size()/2] << "," << nanos[0] << std::endl;
+	}
+
+}//ns
+
+int main(int argc, char** argv) {
+	{
+		using namespace google;
+		using namespace gflags;
+		ParseCommandLineFlags(&argc, &argv, true);
+	}
+	std::vector<std::string> kernels;
+	{
+		std::istringstream ss(FLAGS_kernels);
+		for(std::string item; std::getline(ss, item, ',');) kernels.push_back(item);
+	}
+	auto enabled = [&kernels] (const std::string& kernel) {
+		return kernels.empty() || std::find(kernels.begin(), kernels.end(), kernel) != kernels.end();
+	};
+
+	std::cout << "kernel,magnitude,degree,bits,pieces,ns_median,ns_min" << std::endl;
+	std::default_random_engine generator(42);
+	for(const size_t magnitude : Bench::parseList(FLAGS_magnitudes)) {
+		const Bench::Sweep sweep = Bench::sweep(magnitude, FLAGS_degree, generator);
+		const vektor<IntervalledPolynom>& levels = sweep.levels;
+
+		for(size_t k = 1; k < levels.size(); ++k) { // the pieces of level 0 are constant
+			const IntervalledPolynom& level = levels[k];
+			const vektor<Polynom>& pieces = level.polynomials();
+			const vektor<IB>& intervalbounds = level.bounds();
+			const double bits = averageBits(level);
+
+			if(enabled("sum_from_zero")) {
+				report("sum_from_zero", magnitude, k, bits, pieces.size(), [&] (size_t i) {
+					sink = sumFromZeroToUpper(pieces[i]).size();
+				});
+			}
+
+			SumFromZeroCacher sumcacher; // holds the sums of all pieces of this level
+			for(const Polynom& p : pieces) sumcacher(p);
+			const std::function<const Polynom&(const Polynom&)> SumFromZeroToUpper = [&sumcacher] (const Polynom& a) -> const Polynom& { return sumcacher(a);};
+			if(enabled("gamma_shift")) {
+				const Z gamma = sweep.bounds[k] + 1; // as in the sweep of the next level
+				Polynom ret;
+				report("gamma_shift", magnitude, k, bits, pieces.size(), [&] (size_t i) {
+					sumFromZeroToZMinusGamma(ret, pieces[i], gamma, SumFromZeroToUpper, Binomial::b);
+					sink = ret.size();
+				});
+			}
+			if(enabled("horner")) { // the evaluation of a sum at its interval bound, as in the constant sum of the sweep
+				report("horner", magnitude, k, bits, pieces.size(), [&] (size_t i) {
+					const Polynom& summedUp = sumcacher(pieces[i]);
+					sink = mpz_size(summedUp(intervalbounds[i]).get_num_mpz_t());
+				});
+			}
+			if(enabled("cache_lookup")) {
+				report("cache_lookup", magnitude, k, bits, pieces.size(), [&] (size_t i) {
+					sink = sumcacher(pieces[i]).size();
+				});
+			}
+			if(enabled("at")) {
+				std::uniform_int_distribution<IB> points(0, intervalbounds.back());
+				vektor<IB> queries(pieces.size());
+				for(auto& query : queries) query = points(generator);
+				report("at", magnitude, k, bits, pieces.size(), [&] (size_t i) {
+					sink = level.at(queries[i]).size();
+				});
+			}
+		}
+	}
+	return 0;
+}
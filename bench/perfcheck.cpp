@@ -0,0 +1,257 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file perfcheck.cpp
+ * @brief Compares the running times of some datasets and kernels against a stored baseline
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * Every benchmark is measured -runs times, where a run calls it repeatedly for at least -min_seconds and yields the time per call.
+ * A benchmark regressed if the 95% confidence interval of the relative change of its mean time wrt. the baseline lies entirely above -tolerance,
+ * i.e., if we are confident that it became slower by more than the tolerance.
+ * The exit code is 1 if any benchmark regressed. With -update, the measurements are written as the new baseline instead.
+ */
+
+#include "common.hpp"
+#include "binomial.hpp"
+#include "sum_from_zero_to_upper.hpp"
+#include <gflags/gflags.h>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <regex>
+
+#ifndef PERF_BASELINE_JSON
+#define PERF_BASELINE_JSON "etc/perf_baseline.json"
+#endif
+
+DEFINE_string(datasets, DATASETS_CSV, "The instances to run");
+DEFINE_string(rows, "6,8,11,12,19,20,24", "Comma-separated numbers of the instances to run");
+DEFINE_string(baseline, PERF_BASELINE_JSON, "The baseline to compare with");
+DEFINE_bool(update, false, "Write the measurements to -baseline instead of comparing");
+DEFINE_uint64(runs, 10, "Measurements of each benchmark");
+DEFINE_double(min_seconds, 0.05, "Minimal time of a measurement");
+DEFINE_double(tolerance, 0.1, "Relative slowdown that is not considered a regression");
+
+namespace gflags {}
+namespace google {}
+
+namespace {
+	using namespace IntervalPartition;
+
+	volatile size_t sink; //!< receives a value of every call such that it is not optimized away
+
+	struct Benchmark {
+		std::string name;
+		std::function<void()> call;
+	};
+
+	/** The time per call of the runs of a benchmark, in seconds */
+	struct Measurement {
+		std::string name;
+		size_t runs;
+		double mean;
+		double stddev;
+	};
+
+	/** @return the time per call of calling f repeatedly for at least min_seconds */
+	double measure(const std::function<void()>& f) {
+		size_t calls = 0;
+		const auto timeA = std::chrono::steady_clock::now();
+		double elapsed = 0;
+		do {
+			f();
+			++calls;
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeA).count();
+		} while(elapsed < FLAGS_min_seconds);
+		return elapsed / calls;
+	}
+
+	/**
+	 * Measures the benchmarks in rounds, such that a drift of the speed of the machine affects all benchmarks alike
+	 * and shows up in the standard deviation instead of biasing the mean
+	 */
+	std::vector<Measurement> measure(const std::vector<Benchmark>& benchmarks) {
+		const size_t runs = std::max<uint64_t>(2, FLAGS_runs);
+		std::vector<std::vector<double>> samples(benchmarks.size());
+		for(const Benchmark& benchmark : benchmarks) benchmark.call(); // warmup
+		for(size_t r = 0; r < runs; ++r) {
+			for(size_t b = 0; b < benchmarks.size(); ++b) samples[b].push_back(measure(benchmarks[b].call));
+		}
+		std::vector<Measurement> ret;
+		for(size_t b = 0; b < benchmarks.size(); ++b) {
+			double mean = 0;
+			for(const double sample : samples[b]) mean += sample;
+			mean /= runs;
+			double variance = 0;
+			for(const double sample : samples[b]) variance += (sample-mean)*(sample-mean);
+			variance /= runs-1;
+			ret.push_back(Measurement { benchmarks[b].name, runs, mean, std::sqrt(variance) });
+		}
+		return ret;
+	}
+
+	/** @return the 97.5% quantile of Student's t-distribution with the given degrees of freedom */
+	double tQuantile(const double degrees) {
+		static const double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+		const size_t index = static_cast<size_t>(std::max(1.0, std::floor(degrees)));
+		return index <= 30 ? table[index-1] : 1.960;
+	}
+
+	/**
+	 * Computes Welch's confidence interval of current.mean - baseline.mean, relative to baseline.mean
+	 * @return the change of the means and the half width of its 95% confidence interval
+	 */
+	std::pair<double,double> relativeChange(const Measurement& baseline, const Measurement& current) {
+		const double vb = baseline.stddev*baseline.stddev/baseline.runs;
+		const double vc = current.stddev*current.stddev/current.runs;
+		const double degrees = (vb+vc) == 0 ? 30 : (vb+vc)*(vb+vc) / (vb*vb/(baseline.runs-1) + vc*vc/(current.runs-1));
+		const double halfwidth = tQuantile(degrees) * std::sqrt(vb+vc);
+		return std::make_pair((current.mean-baseline.mean) / baseline.mean, halfwidth / baseline.mean);
+	}
+
+	void json(std::ostream& os, const std::vector<Measurement>& measurements) {
+		os << "{\"min_seconds\": " << FLAGS_min_seconds << ", \"benchmarks\": [";
+		for(size_t i = 0; i < measurements.size(); ++i) {
+			const Measurement& m = measurements[i];
+			os << (i > 0 ? "," : "") << "\n{\"name\": \"" << m.name << "\", \"runs\": " << m.runs << ", \"mean\": " << std::setprecision(6) << m.mean
+				<< ", \"stddev\": " << m.stddev << "}";
+		}
+		os << "\n]}\n";
+	}
+
+	/** Reads the benchmarks of a file written by json */
+	std::vector<Measurement> readJson(std::istream& is) {
+		const std::string content { std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+		const std::regex entry("\\{\"name\": \"([^\"]+)\", \"runs\": ([0-9]+), \"mean\": ([-+.0-9eE]+), \"stddev\": ([-+.0-9eE]+)\\}");
+		std::vector<Measurement> ret;
+		for(std::sregex_iterator it(content.begin(), content.end(), entry); it != std::sregex_iterator(); ++it) {
+			const std::smatch& match = *it;
+			ret.push_back(Measurement { match[1].str(), std::stoul(match[2].str()), std::stod(match[3].str()), std::stod(match[4].str()) });
+		}
+		return ret;
+	}
+
+	/** The sequential engine on some datasets, and the kernels on the pieces of a sweep */
+	std::vector<Benchmark> benchmarks(const std::vector<Bench::Instance>& instances, const Bench::Sweep& sweep, SumFromZeroCacher& sumcacher) {
+		std::vector<Benchmark> ret;
+		const std::vector<size_t> rows = Bench::parseList(FLAGS_rows);
+		for(const Bench::Instance& instance : instances) {
+			if(std::find(rows.begin(), rows.end(), instance.number) == rows.end()) continue;
+			const Bench::Instance* const i = &instance;
+			ret.push_back(Benchmark { "dataset_" + std::to_string(instance.number), [i] () {
+				sink = number_of_interval_partitions(i->bounds.data(), i->bounds.size(), i->z, 1).get_ui();
+			}});
+		}
+		const size_t degree = sweep.levels.size()-1;
+		const IntervalledPolynom& level = sweep.levels[degree];
+		const vektor<Polynom>& pieces = level.polynomials();
+		for(const Polynom& p : pieces) sumcacher(p);
+		const std::string suffix = "_degree_" + std::to_string(degree);
+		ret.push_back(Benchmark { "sum_from_zero" + suffix, [&pieces] () {
+			for(const Polynom& p : pieces) sink = sumFromZeroToUpper(p).size();
+		}});
+		const Z gamma = sweep.bounds[degree] + 1;
+		ret.push_back(Benchmark { "gamma_shift" + suffix, [&pieces, &sumcacher, gamma] () {
+			const std::function<const Polynom&(const Polynom&)> SumFromZeroToUpper = [&sumcacher] (const Polynom& a) -> const Polynom& { return sumcacher(a);};
+			Polynom together;
+			for(const Polynom& p : pieces) {
+				sumFromZeroToZMinusGamma(together, p, gamma, SumFromZeroToUpper, Binomial::b);
+				sink = together.size();
+			}
+		}});
+		ret.push_back(Benchmark { "horner" + suffix, [&level, &sumcacher] () {
+			for(size_t i = 0; i < level.polynomials().size(); ++i) sink = mpz_size(sumcacher(level.piece(i))(level.bounds()[i]).get_num_mpz_t());
+		}});
+		return ret;
+	}
+
+}//ns
+
+int main(int argc, char** argv) {
+	{
+		using namespace google;
+		using namespace gflags;
+		ParseCommandLineFlags(&argc, &argv, true);
+	}
+	std::ifstream file(FLAGS_datasets);
+	if(!file) {
+		std::cerr << "Could not open " << FLAGS_datasets << std::endl;
+		return 1;
+	}
+	const std::vector<Bench::Instance> instances = Bench::readDatasets(file);
+	std::default_random_engine generator(42);
+	const Bench::Sweep sweep = Bench::sweep(10000, 8, generator);
+	SumFromZeroCacher sumcacher;
+
+	const std::vector<Measurement> current = measure(benchmarks(instances, sweep, sumcacher));
+
+	if(FLAGS_update) {
+		std::ofstream output(FLAGS_baseline);
+		json(output, current);
+		if(!output) {
+			std::cerr << "Could not write " << FLAGS_baseline << std::endl;
+			return 1;
+		}
+		std::cout << "Wrote " << current.size() << " benchmarks to " << FLAGS_baseline << std::endl;
+		return 0;
+	}
+
+	std::ifstream baselineFile(FLAGS_baseline);
+	if(!baselineFile) {
+		std::cerr << "Could not open " << FLAGS_baseline << ", create it with -update" << std::endl;
+		return 1;
+	}
+	const std::vector<Measurement> baseline = readJson(baselineFile);
+	bool regressed = false;
+	std::cout << std::left << std::setw(24) << "benchmark" << std::right << std::setw(14) << "baseline [s]" << std::setw(14) << "current [s]"
+		<< std::setw(10) << "change" << std::setw(18) << "95% interval" << "  verdict" << std::endl;
+	std::cout << std::fixed;
+	for(const Measurement& m : current) {
+		const auto it = std::find_if(baseline.begin(), baseline.end(), [&m] (const Measurement& b) { return b.name == m.name; });
+		std::cout << std::left << std::setw(24) << m.name << std::right << std::setprecision(6);
+		if(it == baseline.end()) {
+			std::cout << std::setw(14) << "-" << std::setw(14) << m.mean << std::setw(10) << "-" << std::setw(18) << "-" << "  new" << std::endl;
+			continue;
+		}
+		const auto change = relativeChange(*it, m);
+		const double lower = change.first - change.second;
+		const double upper = change.first + change.second;
+		const char* verdict = "ok";
+		if(lower > FLAGS_tolerance) {
+			verdict = "REGRESSION";
+			regressed = true;
+		}
+		else if(upper < -FLAGS_tolerance) verdict = "faster";
+		std::ostringstream interval;
+		interval << std::showpos << std::fixed << std::setprecision(1) << lower*100 << ".." << upper*100 << "%";
+		std::ostringstream relative;
+		relative << std::showpos << std::fixed << std::setprecision(1) << change.first*100 << "%";
+		std::cout << std::setw(14) << it->mean << std::setw(14) << m.mean << std::setw(10) << relative.str() << std::setw(18) << interval.str() << "  " << verdict << std::endl;
+	}
+	for(const Measurement& b : baseline) {
+		if(std::find_if(current.begin(), current.end(), [&b] (const Measurement& m) { return b.name == m.name; }) == current.end())
+			std::cout << std::left << std::setw(24) << b.name << std::right << "  not measured" << std::endl;
+	}
+	return regressed ? 1 : 0;
+}
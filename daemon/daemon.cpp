@@ -0,0 +1,96 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file daemon.cpp
+ * @brief Answers count queries on a Unix domain socket, caching the built polynomials
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * The protocol is described in protocol.hpp.
+ */
+
+#include "protocol.hpp"
+#include <gflags/gflags.h>
+#include <csignal>
+#include <cstring>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+DEFINE_string(socket, "/tmp/integer_partition.sock", "Path of the Unix domain socket to listen on");
+DEFINE_uint64(cache_mb, 1024, "Memory budget of the polynomial cache in MiB");
+DEFINE_uint64(threads, 1, "Number of threads used to build a single polynomial");
+
+namespace gflags {}
+namespace google {}
+
+namespace {
+
+	void shutdown(int) {
+		unlink(FLAGS_socket.c_str());
+		_exit(0);
+	}
+
+}//ns
+
+int main(int argc, char** argv) {
+	{
+		using namespace google;
+		using namespace gflags;
+		ParseCommandLineFlags(&argc, &argv, true);
+	}
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(FLAGS_socket.size() >= sizeof(address.sun_path)) {
+		std::cerr << "Socket path " << FLAGS_socket << " is too long" << std::endl;
+		return 1;
+	}
+	std::strcpy(address.sun_path, FLAGS_socket.c_str());
+
+	const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(FLAGS_socket.c_str());
+	if(listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 64) != 0) {
+		std::cerr << "Could not listen on " << FLAGS_socket << ": " << std::strerror(errno) << std::endl;
+		return 1;
+	}
+	std::signal(SIGINT, shutdown);
+	std::signal(SIGTERM, shutdown);
+	std::signal(SIGPIPE, SIG_IGN);
+
+	Daemon::Server server(FLAGS_cache_mb << 20, [] (const Daemon::key_type& key) {
+		return FLAGS_threads == 1
+			? IntervalPartition::generateIntervalPartition(key.data(), key.size(), true)
+			: IntervalPartition::generateParallelIntervalPartition(key.data(), key.size(), true, FLAGS_threads);
+	});
+	while(true) {
+		const int connection = accept(listener, nullptr, nullptr);
+		if(connection < 0) {
+			if(errno == EINTR) continue;
+			std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+			break;
+		}
+		std::thread(Daemon::serve, connection, std::ref(server)).detach();
+	}
+	close(listener);
+	unlink(FLAGS_socket.c_str());
+	return 1;
+}
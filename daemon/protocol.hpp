@@ -0,0 +1,312 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file protocol.hpp
+ * @brief Answers the requests of the daemon, independent of the socket it listens on
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * Protocol: every message in both directions is a 4-byte length in native byte order followed by that many bytes.
+ * A request is either
+ *  - "count z i_0 [i_1 [...]]", answered by the number of partitions in decimal, or
+ *  - "stats", answered by a JSON object with cache statistics and latency histograms.
+ * A malformed request, or one whose polynomial could not be built, is answered by a message starting with "error:".
+ * A connection may send any number of requests.
+ */
+#ifndef DAEMON_PROTOCOL_HPP
+#define DAEMON_PROTOCOL_HPP
+
+#include "interval_partition.hpp"
+#include "binomial.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace Daemon {
+
+	using IntervalPartition::IntervalledPolynom;
+	typedef std::vector<unsigned int> key_type; //!< the ascendingly sorted bounds larger than one
+	typedef std::shared_ptr<const IntervalledPolynom> value_type;
+	typedef std::function<IntervalledPolynom(const key_type&)> builder_type; //!< builds the polynomial of a key on a cache miss
+
+	/**
+	 * Approximates the heap memory held by a polynomial
+	 */
+	inline size_t memoryUsage(const IntervalledPolynom& ip) {
+		size_t bytes = sizeof(IntervalledPolynom) + ip.bounds().size() * (2*sizeof(IB) + sizeof(size_t) + sizeof(IntervalPartition::Polynom)); // with the search index
+		for(const IntervalPartition::Polynom& p : ip.polynomials())
+			for(const Q& coeff : p)
+				bytes += sizeof(Q) + (mpz_size(coeff.get_num_mpz_t()) + mpz_size(coeff.get_den_mpz_t())) * sizeof(mp_limb_t);
+		return bytes;
+	}
+
+	/**
+	 * Parses a token consisting only of decimal digits whose value is at most max.
+	 * Unlike operator>>, a leading '-' is rejected instead of being wrapped around.
+	 */
+	inline bool parseNonNegative(const std::string& token, const unsigned long max, unsigned long& value) {
+		if(token.empty() || !std::all_of(token.begin(), token.end(), [] (const char c) { return c >= '0' && c <= '9'; })) return false;
+		try {
+			value = std::stoul(token);
+		} catch(const std::out_of_range&) {
+			return false;
+		}
+		return value <= max;
+	}
+
+	/**
+	 * Latencies in microseconds, bucketed by powers of two
+	 */
+	class Histogram {
+		static constexpr size_t buckets = 40;
+		std::atomic<uint64_t> m_counts[buckets];
+		public:
+		Histogram() { for(auto& c : m_counts) c = 0; }
+		void add(const uint64_t microseconds) {
+			size_t bucket = 0;
+			while(bucket+1 < buckets && (1ULL << bucket) <= microseconds) ++bucket;
+			++m_counts[bucket];
+		}
+		void json(std::ostream& os) const {
+			os << "{";
+			bool first = true;
+			for(size_t i = 0; i < buckets; ++i) {
+				if(m_counts[i] == 0) continue;
+				if(!first) os << ", ";
+				first = false;
+				os << "\"<" << (1ULL << i) << "us\": " << m_counts[i];
+			}
+			os << "}";
+		}
+	};
+
+	/**
+	 * LRU cache of finished polynomials within a memory budget.
+	 * Concurrent misses on the same key wait for a single build.
+	 */
+	class PolynomCache {
+		struct Entry {
+			key_type key;
+			value_type value;
+			size_t bytes;
+		};
+		std::list<Entry> m_lru; //!< most recently used first
+		std::map<key_type, std::list<Entry>::iterator> m_index;
+		std::map<key_type, std::shared_future<value_type>> m_building;
+		std::mutex m_mutex;
+		const size_t m_budget;
+		const builder_type m_build;
+		size_t m_bytes = 0;
+
+		public:
+		std::atomic<uint64_t> hits, misses, evictions;
+
+		PolynomCache(const size_t budget, builder_type build) : m_budget(budget), m_build(std::move(build)), hits(0), misses(0), evictions(0) {}
+
+		/**
+		 * Rethrows the exception of a failed build, also in the requests waiting for it.
+		 * The key of a failed build is not cached, such that a later request builds it again.
+		 */
+		value_type get(const key_type& key, bool& hit) {
+			std::promise<value_type> promise;
+			std::shared_future<value_type> pending;
+			{
+				std::lock_guard<std::mutex> guard(m_mutex);
+				auto it = m_index.find(key);
+				hit = true;
+				if(it != m_index.end()) {
+					++hits;
+					m_lru.splice(m_lru.begin(), m_lru, it->second);
+					return it->second->value;
+				}
+				auto building = m_building.find(key);
+				if(building != m_building.end()) {
+					++hits;
+					pending = building->second;
+				} else {
+					hit = false;
+					++misses;
+					m_building.emplace(key, promise.get_future().share());
+				}
+			}
+			if(pending.valid()) return pending.get();
+			value_type value;
+			try {
+				value = std::make_shared<const IntervalledPolynom>(m_build(key));
+			} catch(...) {
+				{
+					std::lock_guard<std::mutex> guard(m_mutex);
+					m_building.erase(key);
+				}
+				promise.set_exception(std::current_exception());
+				throw;
+			}
+			const size_t bytes = memoryUsage(*value);
+			promise.set_value(value);
+
+			std::lock_guard<std::mutex> guard(m_mutex);
+			m_building.erase(key);
+			if(bytes > m_budget) return value;
+			m_lru.push_front(Entry { key, value, bytes });
+			m_index.emplace(key, m_lru.begin());
+			m_bytes += bytes;
+			while(m_bytes > m_budget) {
+				m_bytes -= m_lru.back().bytes;
+				m_index.erase(m_lru.back().key);
+				m_lru.pop_back();
+				++evictions;
+			}
+			return value;
+		}
+
+		void json(std::ostream& os) {
+			std::lock_guard<std::mutex> guard(m_mutex);
+			os << "{\"entries\": " << m_lru.size() << ", \"bytes\": " << m_bytes << ", \"budget\": " << m_budget
+				<< ", \"hits\": " << hits << ", \"misses\": " << misses << ", \"evictions\": " << evictions << "}";
+		}
+	};
+
+	/**
+	 * Answers the requests of all connections with a shared cache
+	 */
+	class Server {
+		PolynomCache m_cache;
+		Histogram m_hitLatency;
+		Histogram m_missLatency;
+		std::atomic<uint64_t> m_requests;
+		std::atomic<uint64_t> m_errors;
+
+		std::string answerCount(std::istream& ss) {
+			std::string token;
+			if(!(ss >> token)) return "error: expected count z i_0 [i_1 [...]]";
+			unsigned long z;
+			key_type bounds;
+			if(!parseNonNegative(token, std::numeric_limits<unsigned long>::max(), z)) return "error: bounds have to be non-negative integers";
+			for(unsigned long bound; ss >> token; bounds.push_back(bound))
+				if(!parseNonNegative(token, std::numeric_limits<unsigned int>::max(), bound)) return "error: bounds have to be non-negative integers";
+
+			const auto timeA = std::chrono::steady_clock::now();
+			if(z == 0) return "1";
+			if(std::find(bounds.begin(), bounds.end(), 0) != bounds.end()) return "0";
+			const size_t ones = std::count(bounds.begin(), bounds.end(), 1);
+			bounds.erase(std::remove(bounds.begin(), bounds.end(), 1), bounds.end());
+			std::ostringstream result;
+			bool hit = true;
+			if(bounds.empty()) {
+				result << (z <= ones ? IntervalPartition::Binomial::b(ones, z) : Z_zero);
+			} else {
+				std::sort(bounds.begin(), bounds.end()); // the number of partitions does not depend on the order of the bounds
+				value_type polynom;
+				try {
+					polynom = m_cache.get(bounds, hit);
+				} catch(const std::exception& e) {
+					return std::string("error: could not build the polynomial: ") + e.what();
+				}
+				result << IntervalPartition::evaluate_interval_partitions(*polynom, std::accumulate(bounds.begin(), bounds.end(), static_cast<size_t>(0)), ones, z);
+			}
+			const uint64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - timeA).count();
+			(hit ? m_hitLatency : m_missLatency).add(microseconds);
+			return result.str();
+		}
+
+		std::string answerStats() {
+			std::ostringstream os;
+			os << "{\"requests\": " << m_requests << ", \"errors\": " << m_errors << ", \"cache\": ";
+			m_cache.json(os);
+			os << ", \"latency_hit\": ";
+			m_hitLatency.json(os);
+			os << ", \"latency_miss\": ";
+			m_missLatency.json(os);
+			os << "}";
+			return os.str();
+		}
+
+		public:
+		Server(const size_t budget, builder_type build) : m_cache(budget, std::move(build)), m_requests(0), m_errors(0) {}
+
+		const PolynomCache& cache() const { return m_cache; }
+
+		std::string answer(const std::string& request) {
+			++m_requests;
+			std::istringstream ss(request);
+			std::string command;
+			ss >> command;
+			std::string response;
+			if(command == "count") response = answerCount(ss);
+			else if(command == "stats") response = answerStats();
+			else response = "error: unknown command " + command;
+			if(response.compare(0, 6, "error:") == 0) ++m_errors;
+			return response;
+		}
+	};
+
+	inline bool readAll(int fd, char* buffer, size_t length) {
+		while(length > 0) {
+			const ssize_t got = read(fd, buffer, length);
+			if(got <= 0) return false;
+			buffer += got;
+			length -= got;
+		}
+		return true;
+	}
+	inline bool writeAll(int fd, const char* buffer, size_t length) {
+		while(length > 0) {
+			const ssize_t sent = write(fd, buffer, length);
+			if(sent <= 0) return false;
+			buffer += sent;
+			length -= sent;
+		}
+		return true;
+	}
+
+	constexpr uint32_t maxRequestLength = 1 << 26;
+
+	/**
+	 * Answers the requests on a connection until the peer closes it, then closes fd
+	 */
+	inline void serve(int fd, Server& server) {
+		std::string request;
+		for(uint32_t length; readAll(fd, reinterpret_cast<char*>(&length), sizeof(length));) {
+			if(length > maxRequestLength) break;
+			request.resize(length);
+			if(!readAll(fd, &request[0], length)) break;
+			const std::string response = server.answer(request);
+			const uint32_t responseLength = response.size();
+			if(!writeAll(fd, reinterpret_cast<const char*>(&responseLength), sizeof(responseLength))) break;
+			if(!writeAll(fd, response.data(), response.size())) break;
+		}
+		close(fd);
+	}
+
+}//ns
+
+#endif//guard
@@ -19,24 +19,226 @@
 
 #include "interval_partition.hpp"
 #include "binomial.hpp"
+#include "cost_estimate.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include "sum_from_zero_cacher.hpp"
 #include <gflags/gflags.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 DEFINE_uint64(threads, 1, "Number of Threads");
+DEFINE_string(batch, "", "Read newline-delimited queries 'z i_0 [i_1 [...]]' from this file, or from stdin if set to '-'");
+DEFINE_bool(timings, false, "In batch mode, append the computation time of each query in milliseconds");
+DEFINE_uint64(batch_cache_entries, 1 << 16, "In batch mode, a worker drops its cached Faulhaber sums once it holds more than this many");
+DEFINE_bool(stats, false, "Write the performance counters as JSON to stderr after the computation. They are recorded only if built WITH_STATS");
+DEFINE_string(trace, "", "Write the jobs and waits of the parallel generator as Chrome trace JSON to this file. They are recorded only if built WITH_TRACE");
+DEFINE_bool(plan_only, false, "Do not compute the result, but predict the cost of computing it from the interval bounds alone");
+DEFINE_bool(calibrate, false, "With -plan_only, fit the cost per arithmetic operation on this machine before predicting");
+DEFINE_double(nanos_per_operation, IntervalPartition::CostModel().nanosPerOperation, "With -plan_only, the cost of an arithmetic operation, as reported by -calibrate");
+DEFINE_double(nanos_per_limb, IntervalPartition::CostModel().nanosPerLimb, "With -plan_only, the cost of an arithmetic operation per limb, as reported by -calibrate");
 
 
 namespace gflags {}
 namespace google {}
 
+/**
+ * Parses a query 'z i_0 [i_1 [...]]' whose tokens consist only of decimal digits.
+ * Unlike operator>>, a leading '-' is rejected instead of being wrapped around.
+ * @return whether the query is valid
+ */
+bool parseQuery(const std::string& query, unsigned long& z, std::vector<unsigned int>& bounds) {
+	std::istringstream ss(query);
+	size_t tokens = 0;
+	for(std::string token; ss >> token; ++tokens) {
+		if(!std::all_of(token.begin(), token.end(), [] (const char c) { return c >= '0' && c <= '9'; })) return false;
+		errno = 0;
+		const unsigned long value = std::strtoul(token.c_str(), nullptr, 10);
+		if(errno == ERANGE) return false;
+		if(tokens == 0) z = value;
+		else if(value > std::numeric_limits<unsigned int>::max()) return false;
+		else bounds.push_back(value);
+	}
+	return tokens > 0;
+}
+
+/**
+ * Answers every line of input on FLAGS_threads worker threads.
+ * The lines are handed to the workers while they are read, such that a piped producer gets its results without waiting for the end of input.
+ * At most window queries are read but not yet written, which bounds both the queue and the results waiting for a preceding one.
+ * Each worker keeps its own SumFromZeroCacher across the queries it processes, and drops it after it has grown beyond FLAGS_batch_cache_entries.
+ * The results are written in input order as soon as all preceding results are available.
+ */
+int runBatch(std::istream& input) {
+	const size_t numthreads = std::max<size_t>(1, FLAGS_threads);
+	const size_t window = 64*numthreads;
+	std::deque<std::pair<size_t, std::string>> queue; //!< the queries not yet taken by a worker, with their position in the input
+	std::map<size_t, std::string> results; //!< the results waiting for a preceding one
+	size_t read = 0; //!< the number of queries read
+	size_t written = 0; //!< the number of results written
+	bool finished = false; //!< whether the input is exhausted
+	bool failed = false;
+	std::mutex mutex;
+	std::condition_variable queued; //!< a query was queued or the input is exhausted
+	std::condition_variable progressed; //!< a result was written
+
+	auto worker = [&] () {
+		IntervalPartition::SumFromZeroCacher sumcacher;
+		while(true) {
+			std::pair<size_t, std::string> query;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				queued.wait(lock, [&] () { return !queue.empty() || finished; });
+				if(queue.empty()) return;
+				query = std::move(queue.front());
+				queue.pop_front();
+			}
+			if(sumcacher.size() > FLAGS_batch_cache_entries) sumcacher.clear();
+			unsigned long z = 0;
+			std::vector<unsigned int> bounds;
+			const bool valid = parseQuery(query.second, z, bounds);
+			std::ostringstream result;
+			if(!valid) {
+				result << "invalid query: " << query.second;
+			} else {
+				const auto timeA = std::chrono::steady_clock::now();
+				result << IntervalPartition::number_of_interval_partitions(bounds.data(), bounds.size(), z, sumcacher);
+				const auto timeB = std::chrono::steady_clock::now();
+				if(FLAGS_timings) result << " " << std::chrono::duration<double, std::milli>(timeB - timeA).count();
+			}
+
+			std::lock_guard<std::mutex> guard(mutex);
+			results.emplace(query.first, result.str());
+			for(auto it = results.begin(); it != results.end() && it->first == written; it = results.erase(it), ++written)
+				std::cout << it->second << '\n';
+			std::cout.flush();
+			failed |= !valid;
+			progressed.notify_one();
+		}
+	};
+	std::vector<std::thread> threads;
+	for(size_t i = 0; i < numthreads; ++i)
+		threads.emplace_back(worker);
+	for(std::string line; std::getline(input, line);) {
+		const size_t first = line.find_first_not_of(" \t\r");
+		if(first == std::string::npos || line[first] == '#') continue; // blank line or comment
+		std::unique_lock<std::mutex> lock(mutex);
+		progressed.wait(lock, [&] () { return read - written < window; });
+		queue.emplace_back(read++, std::move(line));
+		queued.notify_one();
+	}
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		finished = true;
+	}
+	queued.notify_all();
+	for(auto& thread : threads)
+		thread.join();
+	return failed ? 1 : 0;
+}
+
+/**
+ * Prints the predicted cost of generateIntervalPartition for the given bounds, one line per level
+ */
+int runPlanOnly(const unsigned int* const bounds, const size_t bsize) {
+	IntervalPartition::CostModel model;
+	model.nanosPerOperation = FLAGS_nanos_per_operation;
+	model.nanosPerLimb = FLAGS_nanos_per_limb;
+	if(FLAGS_calibrate) {
+		model = IntervalPartition::calibrateCostModel();
+		std::cout << "# calibrated: -nanos_per_operation " << model.nanosPerOperation << " -nanos_per_limb " << model.nanosPerLimb << std::endl;
+	}
+	std::vector<unsigned int> swept; // number_of_interval_partitions sweeps only over the bounds larger than one
+	for(size_t i = 0; i < bsize; ++i) {
+		if(bounds[i] == 0) {
+			std::cout << "a bound is 0, there is nothing to compute" << std::endl;
+			return 0;
+		}
+		if(bounds[i] > 1) swept.push_back(bounds[i]);
+	}
+	if(swept.empty()) {
+		std::cout << "all bounds are 1, there is nothing to compute" << std::endl;
+		return 0;
+	}
+	const auto timeA = std::chrono::steady_clock::now();
+	const IntervalPartition::SweepPlan plan(swept.data(), swept.size(), true);
+	const IntervalPartition::CostEstimate estimate = IntervalPartition::estimateCost(plan);
+	const auto timeB = std::chrono::steady_clock::now();
+	std::cout << "# level intervals degree coefficient_bits operations bytes" << std::endl;
+	for(size_t k = 0; k < estimate.levels.size(); ++k) {
+		const IntervalPartition::LevelCost& level = estimate.levels[k];
+		std::cout << k << " " << level.intervals << " " << level.degree << " " << level.coefficientBits << " " << level.operations << " " << level.bytes << std::endl;
+	}
+	std::cout << "pieces: " << plan.pieces() << std::endl;
+	std::cout << "operations: " << estimate.operations << std::endl;
+	std::cout << "peak bytes: " << estimate.peakBytes << std::endl;
+	std::cout << "predicted seconds: " << estimate.seconds(model) << std::endl;
+	std::cout << "planning seconds: " << std::chrono::duration<double>(timeB - timeA).count() << std::endl;
+	return 0;
+}
+
+void startTrace() {
+	if(FLAGS_trace.empty()) return;
+	if(!IntervalPartition::Trace::enabled) std::cerr << "# no events recorded, rebuild with -DWITH_TRACE=ON" << std::endl;
+	IntervalPartition::Trace::start();
+}
+
+int writeTrace() {
+	if(FLAGS_trace.empty()) return 0;
+	IntervalPartition::Trace::stop();
+	std::ofstream file(FLAGS_trace);
+	IntervalPartition::Trace::json(file);
+	if(!file) {
+		std::cerr << "Could not write " << FLAGS_trace << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+void printStats() {
+	if(!FLAGS_stats) return;
+	if(!IntervalPartition::Stats::enabled) std::cerr << "# no counters recorded, rebuild with -DWITH_STATS=ON" << std::endl;
+	IntervalPartition::Stats::collect().json(std::cerr);
+	std::cerr << std::endl;
+}
+
 int main(int argc, char** argv) {
 	{
 		using namespace google;
 		using namespace gflags;
 		ParseCommandLineFlags(&argc, &argv, true);
 	}
+	if(!FLAGS_batch.empty()) {
+		int ret;
+		startTrace();
+		if(FLAGS_batch == "-") ret = runBatch(std::cin);
+		else {
+			std::ifstream file(FLAGS_batch);
+			if(!file) {
+				std::cerr << "Could not open " << FLAGS_batch << std::endl;
+				return 1;
+			}
+			ret = runBatch(file);
+		}
+		printStats();
+		return writeTrace() | ret;
+	}
 	if(argc < 3)
 	{
 		std::cout << argv[0] << " - calculate the " << std::endl;
-		std::cout << "Usage: " << argv[0] << " z i_0 [i_1 [i_2 [...]]]" << std::endl;
+		std::cout << "Usage: " << argv[0] << " [-threads n] [-stats] [-trace file] z i_0 [i_1 [i_2 [...]]]" << std::endl;
+		std::cout << "       " << argv[0] << " -batch [file|-] [-timings] [-threads n] [-stats]" << std::endl;
+		std::cout << "       " << argv[0] << " -plan_only [-calibrate] z i_0 [i_1 [i_2 [...]]]" << std::endl;
 		return 1;
 	}
 	const size_t bsize = argc-2;
@@ -45,10 +247,18 @@ int main(int argc, char** argv) {
 	for(size_t i = 2; i < static_cast<size_t>(argc); ++i)
 		bounds[i-2] = strtoul(argv[i], NULL, 10);
 
+	if(FLAGS_plan_only) {
+		const int ret = runPlanOnly(bounds, bsize);
+		delete [] bounds;
+		return ret;
+	}
+	startTrace();
 	std::cout << IntervalPartition::number_of_interval_partitions(bounds, bsize, z, FLAGS_threads) << std::endl;
+	printStats();
+	const int ret = writeTrace();
 
 	delete [] bounds;
-	return 0;
+	return ret;
 }
 
 
@@ -0,0 +1,364 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "approximate_partition.hpp"
+#include "binomial.hpp"
+#include "faulhaber.hpp"
+#include "interval_partition.hpp"
+#include <glog/logging.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace IntervalPartition {
+
+namespace {
+
+	/**
+	 * A real number x with \f$ |x - mid| \le rad \f$
+	 */
+	struct Ball {
+		mpf_class mid;
+		mpf_class rad;
+	};
+
+	/**
+	 * Operations on balls, where the result encloses every real number obtained by the operation on members of the operands.
+	 * mpf truncates the exact result of an operation to at least the precision p of the destination.
+	 * We bound this error conservatively by \f$ 2^{4-p} \f$ times the absolute value of the result.
+	 * The radii are computed with 64 bits, and every radius is enlarged by the factor \f$ 1 + 2^{-50} \f$,
+	 * which exceeds the truncation errors of the few operations computing it.
+	 */
+	class BallArithmetic {
+		static constexpr mp_bitcnt_t radiusPrecision = 64;
+		const mp_bitcnt_t m_precision;
+		mpf_class m_epsilon;
+		mpf_class m_up;
+		mutable mpf_class m_rad; //!< scratch space
+		mutable mpf_class m_term;
+		mutable Ball m_product;
+		mutable Ball m_constant;
+
+		/** Sets the radius of ret to m_rad plus the rounding error of its midpoint, rounded up */
+		void finish(Ball& ret) const {
+			mpf_abs(m_term.get_mpf_t(), ret.mid.get_mpf_t());
+			mpf_mul(m_term.get_mpf_t(), m_term.get_mpf_t(), m_epsilon.get_mpf_t());
+			mpf_add(ret.rad.get_mpf_t(), m_rad.get_mpf_t(), m_term.get_mpf_t());
+			mpf_mul(ret.rad.get_mpf_t(), ret.rad.get_mpf_t(), m_up.get_mpf_t());
+		}
+
+		public:
+		BallArithmetic(const mp_bitcnt_t precision)
+			: m_precision(precision), m_epsilon(1, radiusPrecision), m_up(1, radiusPrecision)
+			, m_rad(0, radiusPrecision), m_term(0, radiusPrecision), m_product(zero()), m_constant(zero())
+		{
+			mpf_div_2exp(m_epsilon.get_mpf_t(), m_epsilon.get_mpf_t(), precision-4);
+			mpf_class tiny(1, radiusPrecision);
+			mpf_div_2exp(tiny.get_mpf_t(), tiny.get_mpf_t(), 50);
+			m_up += tiny;
+		}
+
+		Ball zero() const { return Ball { mpf_class(0, m_precision), mpf_class(0, radiusPrecision) }; }
+		/** @return size balls of the precision of the midpoints */
+		vektor<Ball> zeros(const size_t size) const {
+			vektor<Ball> ret;
+			ret.reserve(size);
+			for(size_t i = 0; i < size; ++i) ret.push_back(zero());
+			return ret;
+		}
+
+		void set(Ball& ret, const Z& x) const {
+			mpf_set_z(ret.mid.get_mpf_t(), x.get_mpz_t());
+			mpf_set_ui(m_rad.get_mpf_t(), 0);
+			if(mpz_sizeinbase(x.get_mpz_t(), 2) <= m_precision) mpf_set_ui(ret.rad.get_mpf_t(), 0); // representable
+			else finish(ret);
+		}
+		void set(Ball& ret, const Q& x) const {
+			mpf_set_q(ret.mid.get_mpf_t(), x.get_mpq_t());
+			mpf_set_ui(m_rad.get_mpf_t(), 0);
+			finish(ret);
+		}
+
+		/** ret = a + b, or ret = a - b if subtract. ret may be a or b. */
+		void add(Ball& ret, const Ball& a, const Ball& b, const bool subtract = false) const {
+			mpf_add(m_rad.get_mpf_t(), a.rad.get_mpf_t(), b.rad.get_mpf_t());
+			if(subtract) mpf_sub(ret.mid.get_mpf_t(), a.mid.get_mpf_t(), b.mid.get_mpf_t());
+			else mpf_add(ret.mid.get_mpf_t(), a.mid.get_mpf_t(), b.mid.get_mpf_t());
+			finish(ret);
+		}
+
+		/** ret = a * b, ret may be a or b. */
+		void mul(Ball& ret, const Ball& a, const Ball& b) const {
+			// |a.mid| b.rad + |b.mid| a.rad + a.rad b.rad
+			mpf_abs(m_term.get_mpf_t(), a.mid.get_mpf_t());
+			mpf_mul(m_rad.get_mpf_t(), m_term.get_mpf_t(), b.rad.get_mpf_t());
+			mpf_abs(m_term.get_mpf_t(), b.mid.get_mpf_t());
+			mpf_mul(m_term.get_mpf_t(), m_term.get_mpf_t(), a.rad.get_mpf_t());
+			mpf_add(m_rad.get_mpf_t(), m_rad.get_mpf_t(), m_term.get_mpf_t());
+			mpf_mul(m_term.get_mpf_t(), a.rad.get_mpf_t(), b.rad.get_mpf_t());
+			mpf_add(m_rad.get_mpf_t(), m_rad.get_mpf_t(), m_term.get_mpf_t());
+			mpf_mul(ret.mid.get_mpf_t(), a.mid.get_mpf_t(), b.mid.get_mpf_t());
+			finish(ret);
+		}
+
+		/** ret += a * b */
+		void addmul(Ball& ret, const Ball& a, const Ball& b) const {
+			mul(m_product, a, b);
+			add(ret, ret, m_product);
+		}
+		/** ret += a * x */
+		void addmul(Ball& ret, const Ball& a, const Z& x) const {
+			set(m_constant, x);
+			addmul(ret, a, m_constant);
+		}
+
+		/**
+		 * Evaluates the polynomial with the coefficients p at the integer w with the Horner method
+		 */
+		void evaluate(Ball& ret, const vektor<Ball>& p, const Z& w) const {
+			DCHECK(!p.empty());
+			set(m_constant, w);
+			ret = p.back();
+			for(size_t l = p.size()-1; l > 0; --l) {
+				mul(ret, ret, m_constant);
+				add(ret, ret, p[l-1]);
+			}
+		}
+
+		/**
+		 * ret += q or ret -= q, where q(w) = p(w + delta) is expanded with the binomial theorem
+		 */
+		void addShifted(vektor<Ball>& ret, const vektor<Ball>& p, const Z& delta, const bool subtract) const {
+			if(ret.size() < p.size()) {
+				const vektor<Ball> more = zeros(p.size() - ret.size());
+				ret.insert(ret.end(), more.begin(), more.end());
+			}
+			Z deltapot;
+			Z factor;
+			for(size_t m = 0; m < p.size(); ++m) {
+				mpz_set_ui(deltapot.get_mpz_t(), 1);
+				for(size_t l = m; l < p.size(); ++l) {
+					mpz_mul(factor.get_mpz_t(), Binomial::b(l,m).get_mpz_t(), deltapot.get_mpz_t());
+					if(subtract) mpz_neg(factor.get_mpz_t(), factor.get_mpz_t());
+					addmul(ret[m], p[l], factor);
+					mpz_mul(deltapot.get_mpz_t(), deltapot.get_mpz_t(), delta.get_mpz_t());
+				}
+			}
+		}
+
+		/** @return rad / (|mid| - rad), which is infinite if the ball contains 0 */
+		double relativeError(const Ball& x) const {
+			mpf_class lower(0, radiusPrecision);
+			mpf_abs(lower.get_mpf_t(), x.mid.get_mpf_t());
+			lower -= x.rad;
+			if(lower <= 0) return std::numeric_limits<double>::infinity();
+			mpf_class ret(x.rad, radiusPrecision);
+			ret /= lower;
+			return ret.get_d() * (1 + 1e-10); // the division and the conversion truncate
+		}
+	};
+	constexpr mp_bitcnt_t BallArithmetic::radiusPrecision;
+
+	/**
+	 * A polynomial in the basis \f$ (z - center)^l \f$ that coincides with a level on the integers [lo, hi]
+	 */
+	struct Piece {
+		IB lo;
+		IB hi;
+		IB center;
+		vektor<Ball> coefficients;
+	};
+
+	/**
+	 * The prefix sums \f$ F(y) = \sum_{t=0}^{y} f(t) \f$ and the suffix sums \f$ G(y) = \sum_{t=y}^{S} f(t) \f$
+	 * of a level f with support [0, S], both in the basis of the pieces of f.
+	 * With the Faulhaber polynomials \f$ S_l(w) = \sum_{v=0}^{w} v^l \f$, the sum of a piece \f$ p(w) = \sum_l a_l w^l \f$ is
+	 * \f$ \sum_{t=lo}^{y} p(t - c) = \tilde{p}(y - c) - \tilde{p}(lo - c - 1) \f$ with \f$ \tilde{p} = \sum_l a_l S_l \f$.
+	 */
+	class Sums {
+		const BallArithmetic& m_arithmetic;
+		const vektor<Piece>& m_pieces;
+		vektor<vektor<Ball>> m_prefix; //!< F(y) = m_prefix[j](y - c_j) for y in the j-th piece
+		vektor<vektor<Ball>> m_suffix; //!< G(y) = m_suffix[j](y - c_j) for y in [lo_j, hi_j + 1]
+		Ball m_total; //!< F(S), used beyond the support
+		Ball m_suffixTotal; //!< G(0), used before the support
+
+		public:
+		Sums(const BallArithmetic& arithmetic, const vektor<vektor<Ball>>& faulhaber, const vektor<Piece>& pieces)
+			: m_arithmetic(arithmetic), m_pieces(pieces), m_total(arithmetic.zero()), m_suffixTotal(arithmetic.zero())
+		{
+			vektor<vektor<Ball>> summed; // \tilde{p} of every piece
+			for(const Piece& piece : pieces) {
+				summed.push_back(arithmetic.zeros(piece.coefficients.size()+1));
+				for(size_t l = 0; l < piece.coefficients.size(); ++l) {
+					for(size_t i = 0; i < faulhaber[l].size(); ++i) arithmetic.addmul(summed.back()[i], piece.coefficients[l], faulhaber[l][i]);
+				}
+			}
+			Ball value = arithmetic.zero();
+			for(size_t j = 0; j < pieces.size(); ++j) { // F(y) = \tilde{p}(y - c) - \tilde{p}(lo - c - 1) + F(lo - 1)
+				const Piece& piece = pieces[j];
+				m_prefix.push_back(summed[j]);
+				arithmetic.evaluate(value, summed[j], Z(piece.lo) - piece.center - 1);
+				arithmetic.add(m_prefix.back()[0], m_prefix.back()[0], value, true);
+				arithmetic.add(m_prefix.back()[0], m_prefix.back()[0], m_total);
+				arithmetic.evaluate(m_total, m_prefix.back(), Z(piece.hi) - piece.center);
+			}
+			m_suffix.resize(pieces.size());
+			for(size_t j = pieces.size(); j > 0; --j) { // G(y) = G(hi + 1) + \tilde{p}(hi - c) - \tilde{p}(y - c) + p(y - c)
+				const Piece& piece = pieces[j-1];
+				vektor<Ball>& suffix = m_suffix[j-1];
+				suffix = arithmetic.zeros(summed[j-1].size());
+				for(size_t i = 0; i < suffix.size(); ++i) arithmetic.add(suffix[i], suffix[i], summed[j-1][i], true);
+				for(size_t i = 0; i < piece.coefficients.size(); ++i) arithmetic.add(suffix[i], suffix[i], piece.coefficients[i]);
+				arithmetic.evaluate(value, summed[j-1], Z(piece.hi) - piece.center);
+				arithmetic.add(suffix[0], suffix[0], value);
+				arithmetic.add(suffix[0], suffix[0], m_suffixTotal);
+				arithmetic.evaluate(m_suffixTotal, suffix, Z(piece.lo) - piece.center);
+			}
+		}
+
+		/**
+		 * Adds or subtracts \f$ F(z - s) \f$ on an interval of z ending at end, in the basis centered at center.
+		 * F(z - s) has to be a single polynomial on this interval.
+		 */
+		void addPrefix(vektor<Ball>& ret, const IB end, const IB center, const IB s, const bool subtract) const {
+			if(end < s) return; // F vanishes on negative values
+			const IB y = end - s;
+			if(y > m_pieces.back().hi) {
+				m_arithmetic.add(ret[0], ret[0], m_total, subtract);
+				return;
+			}
+			const size_t j = index(y);
+			m_arithmetic.addShifted(ret, m_prefix[j], Z(center) - s - m_pieces[j].center, subtract);
+		}
+
+		/**
+		 * Adds or subtracts \f$ G(z + 1 - s) \f$ on an interval of z ending at end, in the basis centered at center.
+		 */
+		void addSuffix(vektor<Ball>& ret, const IB end, const IB center, const IB s, const bool subtract) const {
+			if(end + 1 <= s) { // G is the total on non-positive values
+				m_arithmetic.add(ret[0], ret[0], m_suffixTotal, subtract);
+				return;
+			}
+			const IB y = end + 1 - s;
+			if(y > m_pieces.back().hi + 1) return; // G vanishes beyond the support
+			const size_t j = y == 0 ? 0 : index(y-1); // the first piece with hi_j + 1 >= y
+			m_arithmetic.addShifted(ret, m_suffix[j], Z(center) + 1 - s - m_pieces[j].center, subtract);
+		}
+
+		/** @return F(y) */
+		void prefix(Ball& ret, const Z& y) const {
+			if(y < 0) ret = m_arithmetic.zero();
+			else if(y > m_pieces.back().hi) ret = m_total;
+			else {
+				const size_t j = index(y.get_ui());
+				m_arithmetic.evaluate(ret, m_prefix[j], y - m_pieces[j].center);
+			}
+		}
+
+		private:
+		/** @return the index of the piece containing y */
+		size_t index(const IB y) const {
+			const auto it = std::lower_bound(m_pieces.begin(), m_pieces.end(), y, [] (const Piece& piece, const IB value) { return piece.hi < value; });
+			DCHECK(it != m_pieces.end());
+			return std::distance(m_pieces.begin(), it);
+		}
+	};
+
+	/**
+	 * @return the level \f$ f(z) - f(z - bound - 1) \f$ of the next dimension with the given bound
+	 */
+	vektor<Piece> nextLevel(const BallArithmetic& arithmetic, const vektor<Piece>& pieces, const Sums& sums, const IB bound) {
+		const IB gamma = bound + 1;
+		const IB last = pieces.back().hi + bound;
+		vektor<IB> breakpoints; // z - s moves to the next piece at z = hi_j + s, and z - gamma becomes non-negative after z = gamma - 1
+		breakpoints.push_back(last);
+		breakpoints.push_back(gamma-1);
+		for(const Piece& piece : pieces) {
+			breakpoints.push_back(piece.hi);
+			breakpoints.push_back(piece.hi + gamma);
+		}
+		std::sort(breakpoints.begin(), breakpoints.end());
+		breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+		breakpoints.erase(std::upper_bound(breakpoints.begin(), breakpoints.end(), last), breakpoints.end());
+
+		vektor<Piece> ret;
+		IB lo = 0;
+		for(const IB hi : breakpoints) {
+			Piece piece { lo, hi, lo + (hi-lo)/2, arithmetic.zeros(1) };
+			if(2*piece.center <= last) { // F(z) - F(z - gamma)
+				sums.addPrefix(piece.coefficients, hi, piece.center, 0, false);
+				sums.addPrefix(piece.coefficients, hi, piece.center, gamma, true);
+			} else { // G(z + 1 - gamma) - G(z + 1)
+				sums.addSuffix(piece.coefficients, hi, piece.center, gamma, false);
+				sums.addSuffix(piece.coefficients, hi, piece.center, 0, true);
+			}
+			ret.push_back(std::move(piece));
+			lo = hi+1;
+		}
+		return ret;
+	}
+
+	Approximation exactly(const Z& count) {
+		return Approximation { mpf_class(count, std::max<size_t>(64, mpz_sizeinbase(count.get_mpz_t(), 2))), 0, true };
+	}
+
+}//ns
+
+Approximation approximate_number_of_interval_partitions(const unsigned int* const dimensional_upper_bounds, const size_t dimensions,
+		unsigned long z, const double tolerance, const mp_bitcnt_t precision) {
+	if(z == 0) return exactly(1);
+	if(dimensions == 0) return exactly(0);
+	for(size_t i = 0; i < dimensions; ++i) if(dimensional_upper_bounds[i] == 0) return exactly(0);
+	const size_t boundSum = std::accumulate(dimensional_upper_bounds, dimensional_upper_bounds+dimensions, static_cast<size_t>(0));
+	if(z > boundSum) return exactly(0);
+	if(dimensions == 1) return exactly(1);
+	if(tolerance <= 0 || dimensions >= FAULHABER_DIM) return exactly(number_of_interval_partitions(dimensional_upper_bounds, dimensions, z, 1));
+
+	const BallArithmetic arithmetic(precision);
+	vektor<vektor<Ball>> faulhaber; // the coefficients of S_l
+	for(size_t l = 0; l < dimensions; ++l) {
+		const Polynom& polynom = Faulhaber::f(l);
+		faulhaber.push_back(arithmetic.zeros(polynom.size()));
+		for(size_t i = 0; i < polynom.size(); ++i) arithmetic.set(faulhaber.back()[i], l == 0 && i == 0 ? Q(1) : polynom[i]);
+	}
+
+	vektor<Piece> pieces;
+	pieces.push_back(Piece { 0, dimensional_upper_bounds[0], dimensional_upper_bounds[0]/2, arithmetic.zeros(1) });
+	mpf_set_ui(pieces[0].coefficients[0].mid.get_mpf_t(), 1);
+	for(size_t k = 1; k+1 < dimensions; ++k) {
+		const Sums sums(arithmetic, faulhaber, pieces);
+		pieces = nextLevel(arithmetic, pieces, sums, dimensional_upper_bounds[k]);
+	}
+
+	// the last level is only evaluated at z, which can be mirrored to the lower half of its support
+	if(2*z > boundSum) z = boundSum - z;
+	const Sums sums(arithmetic, faulhaber, pieces);
+	const IB gamma = dimensional_upper_bounds[dimensions-1] + 1UL;
+	Ball count = arithmetic.zero();
+	Ball subtrahend = arithmetic.zero();
+	sums.prefix(count, Z(z));
+	sums.prefix(subtrahend, Z(z) - gamma);
+	arithmetic.add(count, count, subtrahend, true);
+
+	const double relativeError = arithmetic.relativeError(count);
+	DVLOG(1) << "approximate count " << count.mid << " +- " << count.rad << ", relative error " << relativeError;
+	if(relativeError > tolerance) return exactly(number_of_interval_partitions(dimensional_upper_bounds, dimensions, z, 1));
+	return Approximation { count.mid, relativeError, false };
+}
+
+}//ns
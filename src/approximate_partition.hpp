@@ -0,0 +1,62 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file approximate_partition.hpp
+ * @brief Approximates the number of partitions with floating point coefficients and a rigorous error bound
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef APPROXIMATE_PARTITION_HPP
+#define APPROXIMATE_PARTITION_HPP
+#include "definitions.hpp"
+
+namespace IntervalPartition {
+
+	/**
+	 * The answer of approximate_number_of_interval_partitions
+	 */
+	struct Approximation {
+		mpf_class value; //!< the number of partitions, or an approximation of it
+		double relativeError; //!< a rigorous bound on \f$ |value - count| / count \f$, which is 0 if exact
+		bool exact; //!< whether value is the exact number of partitions, e.g., because the bound exceeded the tolerance
+	};
+
+	/**
+	 * Approximates the number of interval partitions with upper bounds for a target value z.
+	 *
+	 * It runs the sweep over the dimensions with floating point coefficients of the given precision instead of rationals.
+	 * Every piece is stored in the basis \f$ (z - c)^l \f$ centered at the middle c of its interval, such that the
+	 * coefficients stay well-conditioned when evaluated inside the interval.
+	 * A piece of level k is \f$ F(z) - F(z - i_k - 1) \f$ with the prefix sums F of level k-1 in the lower half of the support,
+	 * and the difference of the suffix sums in the upper half, such that no term is close to the total.
+	 * Every coefficient is a ball, i.e., a midpoint with a radius that encloses the rounding errors of all operations so far.
+	 * If the radius of the result relative to its value exceeds tolerance, the exact algorithm is run instead.
+	 *
+	 * @param dimensional_upper_bounds The upper bounds. A bound of 0 yields 0 partitions for any z > 0.
+	 * @param dimensions The length of dimensional_upper_bounds
+	 * @param z the target value
+	 * @param tolerance the largest admissible bound on the relative error. With 0, the count is always computed exactly.
+	 * @param precision the number of bits of the midpoints
+	 * @see number_of_interval_partitions
+	 */
+	Approximation approximate_number_of_interval_partitions(const unsigned int* const dimensional_upper_bounds, const size_t dimensions,
+			unsigned long z, const double tolerance, const mp_bitcnt_t precision = 128);
+
+}//ns
+#endif//guard
@@ -21,6 +21,7 @@ function makeList()
 {
 	echo "SET(integer_partition_SRCS `ls *.cpp | tr '\n' ' '`) " 
 	echo "SET(integer_partition_HEADER `ls *.hpp | tr '\n' ' '`) " 
+	echo "SET(integer_partition_C_HEADER `ls *.h | tr '\n' ' '`) " 
 
 }
 
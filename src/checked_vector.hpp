@@ -23,8 +23,10 @@ namespace IntervalPartition {
 		public:
 		checked_vector(size_t _size) : std::vector<T>(_size) {}
 		checked_vector(const checked_vector<T>& pol) : std::vector<T>(pol) {}
-		checked_vector(checked_vector<T>&& pol) : std::vector<T>(pol) {}
+		checked_vector(checked_vector<T>&& pol) : std::vector<T>(std::move(pol)) {}
 		checked_vector() : std::vector<T>() {}
+		checked_vector& operator=(const checked_vector<T>& pol) = default;
+		checked_vector& operator=(checked_vector<T>&& pol) = default;
 #ifndef NDEBUG
 		T& operator[](size_t n) /*override*/ { 
 			DCHECK_LT(n, this->size());
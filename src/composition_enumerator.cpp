@@ -0,0 +1,175 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "composition_enumerator.hpp"
+#include "interval_partition.hpp"
+#include <glog/logging.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace IntervalPartition {
+
+CompositionEnumerator::CompositionEnumerator(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z, Order order)
+	: CompositionEnumerator(dimensional_upper_bounds, dimensions, z, Range { 0, std::numeric_limits<unsigned long>::max(), 0 }, order)
+{}
+
+CompositionEnumerator::CompositionEnumerator(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z, const Range& range, Order order)
+	: m_bounds(dimensional_upper_bounds)
+	, m_dimensions(dimensions)
+	, m_z(z)
+	, m_head_first(range.head_first)
+	, m_head_last(range.head_last)
+	, m_order(order)
+	, m_suffix(dimensions+1)
+	, m_remaining(dimensions)
+	, m_current(dimensions)
+	, m_ascending(dimensions)
+{
+	DCHECK_GT(dimensions, 0);
+	m_suffix[dimensions] = 0;
+	for(size_t j = dimensions; j > 0; --j)
+		m_suffix[j-1] = m_suffix[j] + m_bounds[j-1];
+	reset();
+}
+
+/**
+ * The smallest value x_j can take such that the remaining dimensions can still absorb the rest
+ */
+unsigned long CompositionEnumerator::lowest(size_t j) const {
+	const unsigned long& remaining = m_remaining[j];
+	const unsigned long low = remaining > m_suffix[j+1] ? remaining - m_suffix[j+1] : 0;
+	return j == 0 ? std::max(low, m_head_first) : low;
+}
+
+/**
+ * The largest value x_j can take
+ */
+unsigned long CompositionEnumerator::highest(size_t j) const {
+	const unsigned long high = std::min<unsigned long>(m_bounds[j], m_remaining[j]);
+	return j == 0 ? std::min(high, m_head_last) : high;
+}
+
+/**
+ * Sets x_j,...,x_{n-1} to the first composition of the subtree rooted at x_{j-1}
+ * with respect to the current traversal directions
+ */
+void CompositionEnumerator::fill(size_t j) {
+	for(; j < m_dimensions; ++j) {
+		m_current[j] = m_ascending[j] ? lowest(j) : highest(j);
+		if(j+1 < m_dimensions) m_remaining[j+1] = m_remaining[j] - m_current[j];
+	}
+}
+
+void CompositionEnumerator::reset() {
+	std::fill(m_ascending.begin(), m_ascending.end(), true);
+	m_started = false;
+	m_remaining[0] = m_z;
+	m_exhausted = m_z > m_suffix[0] || lowest(0) > highest(0);
+	if(!m_exhausted) fill(0);
+}
+
+bool CompositionEnumerator::next(unsigned int* composition) {
+	if(m_exhausted) return false;
+	if(m_started) {
+		/**
+		 * Find the deepest dimension that can still move in its direction.
+		 * The last dimension is determined by all others, so it never moves on its own.
+		 * In Order::gray, every deeper dimension that is at its end reverses its direction,
+		 * such that the subtree is traversed backwards and its first composition coincides
+		 * with the last one up to a single unit.
+		 */
+		size_t j = m_dimensions-1;
+		for(; j > 0; --j) {
+			const size_t i = j-1;
+			if(m_ascending[i] ? m_current[i] < highest(i) : m_current[i] > lowest(i)) break;
+			if(m_order == Order::gray) m_ascending[i] = !m_ascending[i];
+		}
+		if(j == 0) {
+			m_exhausted = true;
+			return false;
+		}
+		const size_t i = j-1;
+		if(m_ascending[i]) ++m_current[i];
+		else --m_current[i];
+		m_remaining[i+1] = m_remaining[i] - m_current[i];
+		fill(i+1);
+	}
+	m_started = true;
+	std::copy(m_current.begin(), m_current.end(), composition);
+	return true;
+}
+
+vektor<CompositionEnumerator::Range> CompositionEnumerator::split(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z, const size_t parts) {
+	DCHECK_GT(dimensions, 0);
+	DCHECK_GT(parts, 0);
+	vektor<Range> ranges;
+	const unsigned long tail_capacity = std::accumulate(dimensional_upper_bounds+1, dimensional_upper_bounds+dimensions, 0UL);
+	const unsigned long head_first = z > tail_capacity ? z - tail_capacity : 0;
+	const unsigned long head_last = std::min<unsigned long>(dimensional_upper_bounds[0], z);
+	if(head_first > head_last) return ranges;
+	if(dimensions == 1) {
+		ranges.push_back(Range { head_first, head_last, 1 });
+		return ranges;
+	}
+
+	/**
+	 * The number of compositions with x_0 = v is the number of partitions of z-v into the remaining dimensions.
+	 * The sweep cannot handle bounds of 1, so like countWithBuilder, it runs only over the bounds larger than one,
+	 * and the ones are convolved by evaluate_interval_partitions. A bound of 0 fixes its entry to 0 and is skipped.
+	 */
+	vektor<unsigned int> larger;
+	size_t ones = 0;
+	for(size_t i = 1; i < dimensions; ++i) {
+		if(dimensional_upper_bounds[i] == 1) ++ones;
+		else if(dimensional_upper_bounds[i] > 1) larger.push_back(dimensional_upper_bounds[i]);
+	}
+	const size_t largerSum = std::accumulate(larger.begin(), larger.end(), static_cast<size_t>(0));
+	const IntervalledPolynom tail = larger.empty() ? IntervalledPolynom() : generateIntervalPartition(larger.data(), larger.size(), true);
+	vektor<Z> counts;
+	Z total = 0;
+	for(unsigned long v = head_first; v <= head_last; ++v) {
+		if(z == v) counts.push_back(1);
+		else if(larger.empty()) {
+			counts.emplace_back();
+			mpz_bin_uiui(counts.back().get_mpz_t(), ones, z-v);
+		}
+		else counts.push_back(evaluate_interval_partitions(tail, largerSum, ones, z-v));
+		total += counts.back();
+	}
+
+	/**
+	 * Cut greedily as soon as the running sum reaches the next multiple of total/parts
+	 */
+	Range current { head_first, head_first, 0 };
+	Z done = 0; //!< the number of compositions in the finished ranges and in current
+	size_t part = 1;
+	for(size_t i = 0; i < counts.size(); ++i) {
+		current.head_last = head_first+i;
+		current.count += counts[i];
+		done += counts[i];
+		if(i+1 < counts.size() && part < parts && done*parts >= total*part) {
+			ranges.push_back(current);
+			current = Range { head_first+i+1, head_first+i+1, 0 };
+			while(part < parts && done*parts >= total*part) ++part;
+		}
+	}
+	ranges.push_back(current);
+	return ranges;
+}
+
+}//ns
@@ -0,0 +1,110 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file composition_enumerator.hpp
+ * @brief Enumerates the ordered integer partitions (compositions) of z with upper bounds
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef COMPOSITION_ENUMERATOR_HPP
+#define COMPOSITION_ENUMERATOR_HPP
+#include "definitions.hpp"
+
+namespace IntervalPartition {
+
+	/**
+	 * Visits every composition \f$ (x_0, ..., x_{n-1}) \f$ with \f$ \sum x_i = z \f$ and \f$ 0 \le x_i \le i_i \f$,
+	 * where \f$ i_0, ..., i_{n-1} \f$ are the dimensional upper bounds.
+	 *
+	 * The range of x_j is clamped with the suffix capacities \f$ \sum_{t > j} i_t \f$ such that
+	 * no dead branch is ever entered. Hence each call of next takes \f$ O(n) \f$ time and allocates nothing.
+	 *
+	 * In Order::gray, two consecutive compositions differ by moving a single unit from one dimension to another.
+	 */
+	class CompositionEnumerator
+	{
+		public:
+			enum class Order { lexicographic, gray };
+
+			/**
+			 * A range of values of x_0 and the number of compositions having x_0 in this range.
+			 * Used to split the enumeration among independent consumers.
+			 */
+			struct Range {
+				unsigned long head_first; //!< the smallest value of x_0
+				unsigned long head_last; //!< the largest value of x_0 (inclusive)
+				Z count; //!< the number of compositions with x_0 in [head_first, head_last]
+			};
+
+			/**
+			 * @param dimensional_upper_bounds The upper bounds. The array is not copied and has to outlive the enumerator.
+			 * @param dimensions The length of dimensional_upper_bounds, has to be strictly larger than 0
+			 * @param z the integer to partition
+			 */
+			CompositionEnumerator(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z, Order order = Order::lexicographic);
+
+			/**
+			 * Enumerates only the compositions whose first entry x_0 lies in range
+			 * @see split
+			 */
+			CompositionEnumerator(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z, const Range& range, Order order = Order::lexicographic);
+
+			/**
+			 * Writes the next composition into composition
+			 *
+			 * @param composition a buffer of length dimensions
+			 *
+			 * @return false if all compositions have been visited. In that case, composition is left untouched.
+			 */
+			bool next(unsigned int* composition);
+
+			/**
+			 * Restarts the enumeration from its first composition
+			 */
+			void reset();
+
+			/**
+			 * Splits the enumeration into at most parts ranges of x_0 with roughly the same number of compositions each.
+			 * The counts are obtained from the piecewise-defined polynomial of the bounds i_1,...,i_{n-1}.
+			 * The ranges are disjoint, ascending, and cover all compositions.
+			 * A single value of x_0 is never split, so fewer than parts ranges can be returned.
+			 */
+			static vektor<Range> split(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z, const size_t parts);
+
+		private:
+			const unsigned int* const m_bounds;
+			const size_t m_dimensions;
+			const unsigned long m_z;
+			const unsigned long m_head_first;
+			const unsigned long m_head_last;
+			const Order m_order;
+			vektor<unsigned long> m_suffix; //!< m_suffix[j] is the sum of all bounds i_j,...,i_{n-1}
+			vektor<unsigned long> m_remaining; //!< m_remaining[j] is z minus the sum of x_0,...,x_{j-1}
+			vektor<unsigned int> m_current;
+			vektor<char> m_ascending; //!< the direction in which x_j is currently traversed
+			bool m_started;
+			bool m_exhausted;
+
+			unsigned long lowest(size_t j) const;
+			unsigned long highest(size_t j) const;
+			void fill(size_t j);
+	};
+
+}//ns
+#endif//guard
@@ -0,0 +1,164 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "composition_rank.hpp"
+#include "interval_partition.hpp"
+#include <glog/logging.h>
+#include <algorithm>
+#include <numeric>
+
+namespace IntervalPartition {
+
+Z CompositionRanker::prefixCount(const size_t j, const Z& s) const {
+	if(s < 0) return 0;
+	auto larger = [&] (const Z& t) -> Z { //!< the prefix count of the dimensions larger than one
+		if(t < 0) return 0;
+		if(m_larger[j] == 0) return 1; // only the empty partition
+		const Q ret = m_levels[m_larger[j]-1].prefix_sum(t);
+		DCHECK_EQ(ret.get_den(), 1);
+		return ret.get_num();
+	};
+	const size_t ones = m_ones[j];
+	if(ones == 0) return larger(s);
+	/**
+	 * The dimensions with bound 1 are convolved binomially: \f$ P_j(s) = \sum_{k=0}^{\min(ones,s)} {ones \choose k} P'_j(s-k) \f$,
+	 * where \f$ P'_j \f$ is the prefix count of the dimensions larger than one.
+	 */
+	Z ret = 0;
+	Z binomial = 1; //!< \f$ {ones \choose k} \f$
+	for(size_t k = 0; k <= ones && s >= k; ++k) {
+		ret += binomial * larger(s-k);
+		mpz_mul_ui(binomial.get_mpz_t(), binomial.get_mpz_t(), ones-k);
+		mpz_divexact_ui(binomial.get_mpz_t(), binomial.get_mpz_t(), k+1);
+	}
+	return ret;
+}
+
+CompositionRanker::CompositionRanker(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z)
+	: m_bounds(dimensions), m_z(z), m_larger(dimensions+1), m_ones(dimensions+1)
+{
+	DCHECK_GT(dimensions, 0);
+	std::copy(dimensional_upper_bounds, dimensional_upper_bounds+dimensions, m_bounds.begin());
+
+	/**
+	 * The sweep cannot handle bounds of 1, so it runs only over the reversed bounds larger than one.
+	 * Its k-th level counts the partitions into the last k+1 dimensions larger than one.
+	 * A bound of 0 fixes its entry to 0, such that it changes none of the counts.
+	 */
+	vektor<unsigned int> reversed;
+	m_larger[dimensions] = m_ones[dimensions] = 0;
+	for(size_t j = dimensions; j-- > 0;) {
+		m_larger[j] = m_larger[j+1];
+		m_ones[j] = m_ones[j+1];
+		if(m_bounds[j] == 1) ++m_ones[j];
+		else if(m_bounds[j] > 1) {
+			++m_larger[j];
+			reversed.push_back(m_bounds[j]);
+		}
+	}
+	if(!reversed.empty()) {
+		generateIntervalPartition(reversed.data(), reversed.size(), false, &m_levels);
+		DCHECK_EQ(m_levels.size(), reversed.size());
+		for(IntervalledPolynom& level : m_levels) {
+			level.buildPrefixSums();
+			level.freeze();
+		}
+	}
+	m_count = prefixCount(0, z) - prefixCount(0, Z(z)-1);
+}
+
+Z CompositionRanker::rank(const unsigned int* composition) const {
+	DCHECK_EQ(std::accumulate(composition, composition+m_bounds.size(), 0UL), m_z);
+	Z ret = 0;
+	unsigned long remaining = m_z;
+	for(size_t j = 0; j+1 < m_bounds.size(); ++j) {
+		DCHECK_LE(composition[j], m_bounds[j]);
+		ret += prefixCount(j+1, remaining) - prefixCount(j+1, Z(remaining) - composition[j]);
+		remaining -= composition[j];
+	}
+	return ret;
+}
+
+unsigned long CompositionRanker::choose(const size_t j, const unsigned long remaining, Z& index) const {
+	const Z upper = prefixCount(j+1, remaining);
+	/**
+	 * skipped(v) is the number of compositions with x_j < v. It is zero for every infeasible v,
+	 * so we can search over [0, min(i_j, remaining)] for the largest v with skipped(v) <= index.
+	 */
+	auto skipped = [&] (const unsigned long v) -> Z { return upper - prefixCount(j+1, Z(remaining) - v); };
+	unsigned long low = 0;
+	unsigned long high = std::min<unsigned long>(m_bounds[j], remaining);
+	while(low < high) {
+		const unsigned long mid = low + (high-low+1)/2;
+		if(skipped(mid) <= index) low = mid;
+		else high = mid-1;
+	}
+	index -= skipped(low);
+	return low;
+}
+
+void CompositionRanker::unrank(const Z& index, unsigned int* composition) const {
+	DCHECK_GE(index, 0);
+	DCHECK_LT(index, m_count);
+	Z local = index;
+	unsigned long remaining = m_z;
+	for(size_t j = 0; j+1 < m_bounds.size(); ++j) {
+		composition[j] = choose(j, remaining, local);
+		remaining -= composition[j];
+	}
+	DCHECK_EQ(local, 0);
+	composition[m_bounds.size()-1] = remaining;
+}
+
+void CompositionRanker::unrank(const Z* indices, const size_t size, unsigned int* compositions) const {
+	const size_t dimensions = m_bounds.size();
+	vektor<size_t> order(size);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&] (const size_t a, const size_t b) { return indices[a] < indices[b]; });
+
+	/**
+	 * The subtree of x_0,...,x_{j-1} contains the ranks [base[j], end[j]).
+	 * The first valid levels keep their choice as long as the next index stays in the subtree of level j+1.
+	 */
+	vektor<unsigned int> current(dimensions);
+	vektor<unsigned long> remaining(dimensions);
+	vektor<Z> base(dimensions);
+	vektor<Z> end(dimensions);
+	remaining[0] = m_z;
+	base[0] = 0;
+	end[0] = m_count;
+	size_t valid = 0;
+	for(const size_t& position : order) {
+		const Z& index = indices[position];
+		DCHECK_GE(index, 0);
+		DCHECK_LT(index, m_count);
+		size_t j = 0;
+		while(j < valid && index >= base[j+1] && index < end[j+1]) ++j;
+		for(; j+1 < dimensions; ++j) {
+			Z local = index - base[j];
+			current[j] = choose(j, remaining[j], local);
+			remaining[j+1] = remaining[j] - current[j];
+			base[j+1] = index - local;
+			end[j+1] = base[j+1] + prefixCount(j+1, remaining[j+1]) - prefixCount(j+1, Z(remaining[j+1])-1);
+		}
+		valid = dimensions-1;
+		current[dimensions-1] = remaining[dimensions-1];
+		std::copy(current.begin(), current.end(), compositions + position*dimensions);
+	}
+}
+
+}//ns
@@ -0,0 +1,103 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file composition_rank.hpp
+ * @brief Bijection between the compositions of z with upper bounds and the integers [0, count)
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef COMPOSITION_RANK_HPP
+#define COMPOSITION_RANK_HPP
+#include "intervalled_polynom.hpp"
+
+namespace IntervalPartition {
+
+	/**
+	 * Ranks and unranks the compositions \f$ (x_0, ..., x_{n-1}) \f$ of z with \f$ 0 \le x_i \le i_i \f$
+	 * with respect to the lexicographic order, i.e., the order of CompositionEnumerator::Order::lexicographic.
+	 *
+	 * Let \f$ C_j(s) \f$ be the number of partitions of s into the dimensions j,...,n-1 and
+	 * \f$ P_j(s) = \sum_{t=0}^{s} C_j(t) \f$. Then the rank of a composition is
+	 * \f$ \sum_{j=0}^{n-2} P_{j+1}(r_j) - P_{j+1}(r_j - x_j) \f$ with \f$ r_j = z - \sum_{t<j} x_t \f$.
+	 * The functions \f$ C_j \f$ without the dimensions with bound 1 are the levels of the sweep over the reversed bounds larger than one.
+	 * \f$ P_j \f$ is evaluated with IntervalledPolynom::prefix_sum, convolved with the binomial coefficients of the o dimensions with bound 1.
+	 */
+	class CompositionRanker
+	{
+		public:
+			/**
+			 * Builds the prefix count functions of every suffix of the bounds.
+			 * @param dimensional_upper_bounds The upper bounds, where a bound of 0 fixes its entry to 0. The array is copied.
+			 * @param dimensions The length of dimensional_upper_bounds, has to be strictly larger than 0
+			 * @param z the integer to partition
+			 */
+			CompositionRanker(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const unsigned long z);
+
+			/**
+			 * @return the number of compositions of z
+			 */
+			const Z& count() const { return m_count; }
+
+			/**
+			 * Takes \f$ O(n) \f$ evaluations of prefix count functions, each costing \f$ O(o (\log I + d)) \f$
+			 * with I intervals of degree d and o dimensions with bound 1.
+			 * @pre composition is a composition of z obeying the upper bounds
+			 *
+			 * @return the number of compositions that are lexicographically smaller than composition
+			 */
+			Z rank(const unsigned int* composition) const;
+
+			/**
+			 * Writes the composition with the given rank into composition.
+			 * The entry x_j is found by a binary search over its feasible values,
+			 * such that it takes \f$ O(n \log \max_j i_j) \f$ evaluations of prefix count functions.
+			 * @pre 0 <= index < count()
+			 */
+			void unrank(const Z& index, unsigned int* composition) const;
+
+			/**
+			 * Unranks size indices at once. compositions[i*n], ..., compositions[i*n+n-1] receives the composition of indices[i].
+			 * The indices are processed in ascending order, such that the choices of x_0,...,x_j are reused
+			 * as long as consecutive indices fall into the same subtree.
+			 */
+			void unrank(const Z* indices, const size_t size, unsigned int* compositions) const;
+
+		private:
+			vektor<unsigned int> m_bounds;
+			const unsigned long m_z;
+			vektor<IntervalledPolynom> m_levels; //!< m_levels[k] counts the partitions into the last k+1 dimensions larger than one, with prefix sums
+			vektor<size_t> m_larger; //!< m_larger[j] is the number of dimensions j,...,n-1 with a bound larger than one
+			vektor<size_t> m_ones; //!< m_ones[j] is the number of dimensions j,...,n-1 with bound 1
+			Z m_count;
+
+			/**
+			 * @return \f$ P_j(s) \f$ for 0 <= j <= n, which is 0 for s < 0
+			 */
+			Z prefixCount(const size_t j, const Z& s) const;
+
+			/**
+			 * Chooses x_j with remaining sum r among the compositions ranked [0, C_j(r)) in its subtree
+			 * @param index the rank inside the subtree, decreased by the number of compositions skipped
+			 * @return x_j
+			 */
+			unsigned long choose(const size_t j, const unsigned long remaining, Z& index) const;
+	};
+
+}//ns
+#endif//guard
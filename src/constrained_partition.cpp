@@ -0,0 +1,195 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "constrained_partition.hpp"
+#include "binomial.hpp"
+#include "interval_partition.hpp"
+#include <glog/logging.h>
+#include <algorithm>
+
+namespace IntervalPartition {
+
+namespace {
+
+	/**
+	 * Computes q with q(x) = p(x - shift) by expanding \f$ (x - shift)^l \f$ with the binomial theorem
+	 */
+	void shiftArgument(Polynom& ret, const Polynom& p, const Z& shift) {
+		Z shiftpot;
+		Z factor;
+		Q product;
+		ret.resize(p.size());
+		for(size_t m = 0; m < p.size(); ++m) {
+			Q& coeff = ret[m];
+			mpq_set_ui(coeff.get_mpq_t(), 0, 1);
+			mpz_set_ui(shiftpot.get_mpz_t(), 1);
+			for(size_t l = m; l < p.size(); ++l) {
+				mpz_mul(factor.get_mpz_t(), Binomial::b(l,m).get_mpz_t(), shiftpot.get_mpz_t());
+				mpq_set_z(product.get_mpq_t(), factor.get_mpz_t());
+				mpq_mul(product.get_mpq_t(), product.get_mpq_t(), p[l].get_mpq_t());
+				mpq_add(coeff.get_mpq_t(), coeff.get_mpq_t(), product.get_mpq_t());
+				mpz_mul(shiftpot.get_mpz_t(), shiftpot.get_mpz_t(), shift.get_mpz_t());
+				mpz_neg(shiftpot.get_mpz_t(), shiftpot.get_mpz_t());
+			}
+		}
+	}
+
+	/**
+	 * @return g with g(z) = f(z - shift), which is zero for z < shift
+	 */
+	IntervalledPolynom translate(const IntervalledPolynom& f, const IB shift) {
+		IntervalledPolynom ret;
+		if(shift > 0) ret.push_back(shift-1, Polynom(Polynom::zero));
+		const Z zshift = shift;
+		for(size_t i = 0; i < f.bounds().size(); ++i) {
+			Polynom shifted;
+			shiftArgument(shifted, f.piece(i), zshift);
+			ret.push_back(f.bounds()[i] + shift, std::move(shifted));
+		}
+		return ret;
+	}
+
+	/**
+	 * The admissible values of every dimension as disjoint intervals in ascending order
+	 */
+	struct Constraints {
+		bool empty = false; //!< whether a dimension has no admissible value
+		IB shift = 0; //!< the sum of the lower bounds of the dimensions in widths
+		vektor<unsigned int> widths; //!< the widths of the dimensions with a single interval that is longer than one value
+		vektor<vektor<std::pair<IB,IB>>> constrained; //!< the admissible intervals of the other dimensions
+	};
+
+	Constraints analyze(const unsigned int* const lower_bounds, const unsigned int* const upper_bounds,
+			const vektor<unsigned int>* const forbidden, const size_t dimensions) {
+		Constraints ret;
+		for(size_t i = 0; i < dimensions; ++i) {
+			const IB lower = lower_bounds == nullptr ? 0 : lower_bounds[i];
+			const IB upper = upper_bounds[i];
+			vektor<IB> excluded;
+			if(forbidden != nullptr) {
+				for(const unsigned int value : forbidden[i]) if(lower <= value && value <= upper) excluded.push_back(value);
+				std::sort(excluded.begin(), excluded.end());
+			}
+			vektor<std::pair<IB,IB>> allowed;
+			IB start = lower;
+			for(const IB value : excluded) {
+				if(value > start) allowed.emplace_back(start, value-1);
+				start = std::max(start, value+1);
+			}
+			if(start <= upper) allowed.emplace_back(start, upper);
+
+			if(allowed.empty()) {
+				ret.empty = true;
+				return ret;
+			}
+			if(allowed.size() == 1) { // forbidden values at the ends only narrow the bounds
+				ret.shift += allowed[0].first;
+				if(allowed[0].second > allowed[0].first) ret.widths.push_back(allowed[0].second - allowed[0].first);
+			} else {
+				ret.constrained.push_back(std::move(allowed));
+			}
+		}
+		return ret;
+	}
+
+}//ns
+
+IntervalledPolynom convolveWithIntervals(const IntervalledPolynom& f, const vektor<std::pair<IB,IB>>& allowed) {
+	IntervalledPolynom ret;
+	const vektor<IB>& intervalbounds = f.bounds();
+	if(allowed.empty() || intervalbounds.empty()) return ret;
+
+	/**
+	 * F(y) = prefix.prefixPiece(i)(y) on the i-th interval of f, F(y) = 0 for y < 0, and F(y) = total beyond the last interval
+	 */
+	IntervalledPolynom prefix(f);
+	prefix.buildPrefixSums();
+	const Q total = prefix.total_sum();
+
+	vektor<std::pair<IB,bool>> terms; // the shifts c of the terms F(z - c), and whether the term is subtracted
+	for(const auto& interval : allowed) {
+		DCHECK_LE(interval.first, interval.second);
+		DCHECK(terms.empty() || terms.back().first <= interval.first);
+		terms.emplace_back(interval.first, false);
+		terms.emplace_back(interval.second+1, true);
+	}
+
+	// z - c moves to the next interval of F at z = c - 1 and z = c + i_j
+	const IB last = intervalbounds.back() + allowed.back().second;
+	vektor<IB> breakpoints;
+	breakpoints.push_back(last);
+	for(const auto& term : terms) {
+		if(term.first > 0) breakpoints.push_back(term.first-1);
+		for(const IB bound : intervalbounds) breakpoints.push_back(bound + term.first);
+	}
+	std::sort(breakpoints.begin(), breakpoints.end());
+	breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+	breakpoints.erase(std::upper_bound(breakpoints.begin(), breakpoints.end(), last), breakpoints.end());
+
+	Polynom shifted;
+	for(const IB breakpoint : breakpoints) {
+		Polynom piece(Polynom::zero);
+		for(const auto& term : terms) {
+			if(breakpoint < term.first) continue; // F(z - c) = 0 on the whole interval
+			const IB y = breakpoint - term.first;
+			if(y > intervalbounds.back()) {
+				if(term.second) piece[0] -= total;
+				else piece[0] += total;
+				continue;
+			}
+			const size_t index = std::distance(intervalbounds.begin(), std::lower_bound(intervalbounds.begin(), intervalbounds.end(), y));
+			shiftArgument(shifted, prefix.prefixPiece(index), term.first);
+			if(term.second) piece -= shifted;
+			else piece += shifted;
+		}
+		ret.push_back(breakpoint, std::move(piece));
+	}
+	return ret;
+}
+
+IntervalledPolynom generateConstrainedPartition(const unsigned int* const lower_bounds, const unsigned int* const upper_bounds,
+		const vektor<unsigned int>* const forbidden, const size_t dimensions) {
+	const Constraints constraints = analyze(lower_bounds, upper_bounds, forbidden, dimensions);
+	IntervalledPolynom ret;
+	if(constraints.empty) return ret;
+	vektor<unsigned int> swept; // the sweep needs bounds larger than one, the others are convolved with [0,1]
+	for(const unsigned int width : constraints.widths) if(width > 1) swept.push_back(width);
+	if(swept.empty()) ret.push_back(0, Polynom(Polynom::one));
+	else ret = generateIntervalPartition(swept.data(), swept.size(), false);
+	vektor<std::pair<IB,IB>> zeroOrOne(1);
+	zeroOrOne[0] = std::make_pair<IB,IB>(0, 1);
+	for(size_t ones = constraints.widths.size() - swept.size(); ones > 0; --ones) ret = convolveWithIntervals(ret, zeroOrOne);
+	if(constraints.shift > 0) ret = translate(ret, constraints.shift);
+	for(const auto& allowed : constraints.constrained) ret = convolveWithIntervals(ret, allowed);
+	ret.freeze();
+	return ret;
+}
+
+Z number_of_constrained_partitions(const unsigned int* const lower_bounds, const unsigned int* const upper_bounds,
+		const vektor<unsigned int>* const forbidden, const size_t dimensions, unsigned long z) {
+	const Constraints constraints = analyze(lower_bounds, upper_bounds, forbidden, dimensions);
+	if(constraints.empty) return 0;
+	if(constraints.constrained.empty()) {
+		if(z < constraints.shift) return 0;
+		return number_of_interval_partitions(constraints.widths.data(), constraints.widths.size(), z - constraints.shift, 1);
+	}
+	Q count = generateConstrainedPartition(lower_bounds, upper_bounds, forbidden, dimensions)(static_cast<IB>(z));
+	DCHECK_EQ(count.get_den(), 1);
+	return count.get_num();
+}
+
+}//ns
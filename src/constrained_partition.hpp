@@ -0,0 +1,71 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file constrained_partition.hpp
+ * @brief Counts the compositions with lower bounds, upper bounds and forbidden values per dimension
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef CONSTRAINED_PARTITION_HPP
+#define CONSTRAINED_PARTITION_HPP
+#include "intervalled_polynom.hpp"
+#include <utility>
+
+namespace IntervalPartition {
+
+	/**
+	 * Convolves a piecewise-defined polynomial f with the indicator of a union of intervals, i.e.,
+	 * computes \f$ g(z) = \sum_{t \in A} f(z - t) \f$ with \f$ A = [a_0, b_0] \cup ... \cup [a_{m-1}, b_{m-1}] \f$.
+	 * With the prefix sums \f$ F(y) = \sum_{t=0}^{y} f(t) \f$, this is \f$ g(z) = \sum_r F(z - a_r) - F(z - b_r - 1) \f$.
+	 * Every interval of A contributes the breakpoints of F shifted by \f$ a_r \f$ and \f$ b_r + 1 \f$,
+	 * such that the gaps between the intervals become further breakpoints of g.
+	 *
+	 * @param f a piecewise-defined polynomial with f(t) = 0 for t < 0
+	 * @param allowed the intervals \f$ [a_r, b_r] \f$, disjoint and in ascending order
+	 * @return g, which is zero beyond the last bound of f plus \f$ b_{m-1} \f$
+	 */
+	IntervalledPolynom convolveWithIntervals(const IntervalledPolynom& f, const vektor<std::pair<IB,IB>>& allowed);
+
+	/**
+	 * Returns a piecewise-defined polynomial that evaluates for a given integer z the number of compositions
+	 * \f$ (x_0, ..., x_{n-1}) \f$ of z with \f$ l_i \le x_i \le u_i \f$ and \f$ x_i \f$ not being a forbidden value of dimension i.
+	 *
+	 * The dimensions whose admissible values form a single interval are shifted by their lower bounds
+	 * and swept by generateIntervalPartition, the others are convolved with convolveWithIntervals.
+	 *
+	 * @param lower_bounds the lower bounds \f$ l_i \f$, or nullptr if all are zero
+	 * @param upper_bounds the upper bounds \f$ u_i \f$. A dimension with \f$ u_i < l_i \f$ admits no composition.
+	 * @param forbidden if not null, forbidden[i] holds the forbidden values of dimension i in any order.
+	 *  Values outside of \f$ [l_i, u_i] \f$ are ignored.
+	 * @param dimensions The length of the arrays
+	 */
+	IntervalledPolynom generateConstrainedPartition(const unsigned int* const lower_bounds, const unsigned int* const upper_bounds,
+			const vektor<unsigned int>* const forbidden, const size_t dimensions);
+
+	/**
+	 * Computes the number of compositions of z with lower bounds, upper bounds and forbidden values.
+	 * If no dimension has a forbidden value inside its bounds, this is number_of_interval_partitions of the widths
+	 * \f$ u_i - l_i \f$ and \f$ z - \sum_i l_i \f$.
+	 * @see generateConstrainedPartition
+	 */
+	Z number_of_constrained_partitions(const unsigned int* const lower_bounds, const unsigned int* const upper_bounds,
+			const vektor<unsigned int>* const forbidden, const size_t dimensions, unsigned long z);
+
+}//ns
+#endif//guard
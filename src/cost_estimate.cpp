@@ -0,0 +1,130 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "cost_estimate.hpp"
+#include "interval_partition.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace IntervalPartition
+{
+
+	namespace {
+		constexpr size_t limbBits = 8*sizeof(mp_limb_t);
+		constexpr size_t mallocBytes = 16; //!< the bookkeeping of the allocator per allocation
+
+		/** @return the bytes of a polynomial with the given number of coefficients */
+		size_t polynomBytes(const size_t coefficients, const size_t coefficientBits) {
+			const size_t limbs = std::max<size_t>(2, 2*((coefficientBits/2 + limbBits-1)/limbBits)); // numerator and denominator hold at least one limb each
+			return sizeof(Polynom) + mallocBytes + coefficients * (sizeof(Q) + 2*mallocBytes + limbs*sizeof(mp_limb_t));
+		}
+	}
+
+	/**
+	 * The counts follow the loops of sumPolynomialOverWitnesses and sum_from_zero_to_upper.hpp.
+	 * A polynomial of level k has degree k. Its coefficients are rationals whose denominators divide k!,
+	 * and whose numerators are bounded by k times the bits of the largest interval bound, cf. the binomial expansion in sumFromZeroToZMinusGamma.
+	 */
+	CostEstimate estimateCost(const SweepPlan& plan) {
+		CostEstimate estimate;
+		estimate.levels.resize(plan.dimensions());
+		size_t planBytes = 0;
+		double logFactorial = 0;
+		for(size_t k = 0; k < plan.dimensions(); ++k) {
+			const SweepPlan::Level& level = plan.level(k);
+			planBytes += level.bounds.size()*sizeof(IB) + level.witnesses.size()*sizeof(SweepPlan::Witness);
+		}
+		for(size_t k = 0; k < plan.dimensions(); ++k) {
+			const SweepPlan::Level& level = plan.level(k);
+			LevelCost& cost = estimate.levels[k];
+			if(k > 0) logFactorial += std::log2(static_cast<double>(k));
+			cost.intervals = level.bounds.size();
+			cost.degree = k;
+			cost.coefficientBits = 2 + static_cast<size_t>(k*std::log2(static_cast<double>(level.bounds.back())+1) + logFactorial);
+			cost.bytes = level.bounds.size()*(2*sizeof(IB) + sizeof(size_t)) + level.bounds.size()*polynomBytes(k+1, cost.coefficientBits);
+			cost.operations = 0;
+			size_t sumBytes = 0; //!< the table of the Faulhaber sums of the previous level
+			if(k > 0) {
+				const LevelCost& previous = estimate.levels[k-1];
+				const double n = k; //!< the number of coefficients of a polynomial of the previous level
+				const double s = n+1; //!< the number of coefficients of its Faulhaber sum
+				// every piece of the previous level is summed up once into the table of the level,
+				// and its total over its interval is evaluated twice for the prefix sums of the constant sums
+				cost.operations += previous.intervals * (n*(n+3)/2 + 2*s);
+				sumBytes = previous.intervals * polynomBytes(k+1, previous.coefficientBits);
+				for(const SweepPlan::Witness& witness : level.witnesses) {
+					if(witness.left == witness.right) {
+						cost.operations += s*(s+1)/2 + s;
+						continue;
+					}
+					if(witness.left >= 1 && witness.left-1 < previous.intervals) cost.operations += s*(s+1)/2 + 2*s;
+					if(witness.right-witness.left > 1) cost.operations += 1; // a subtraction of prefix sums
+					cost.operations += 3*s;
+				}
+			}
+			cost.limbOperations = cost.operations * ((cost.coefficientBits + limbBits-1)/limbBits);
+			estimate.operations += cost.operations;
+			estimate.limbOperations += cost.limbOperations;
+			estimate.peakBytes = std::max(estimate.peakBytes, planBytes + sumBytes + cost.bytes + (k > 0 ? estimate.levels[k-1].bytes : 0));
+		}
+		return estimate;
+	}
+
+	CostModel calibrateCostModel(const double seconds) {
+		std::default_random_engine generator(42);
+		std::uniform_int_distribution<unsigned int> distribution(2, 200); // the sweep cannot handle bounds of 1, which runPlanOnly strips before planning
+		vektor<CostEstimate> estimates;
+		vektor<double> timings;
+		double elapsed = 0;
+		for(size_t dimensions = 4; elapsed < seconds; ++dimensions) {
+			vektor<unsigned int> bounds(dimensions);
+			for(auto& bound : bounds) bound = distribution(generator);
+			const SweepPlan plan(bounds.data(), dimensions, false);
+			const auto timeA = std::chrono::steady_clock::now();
+			generateIntervalPartition(plan);
+			const double measured = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeA).count();
+			estimates.push_back(estimateCost(plan));
+			timings.push_back(measured);
+			elapsed += measured;
+		}
+
+		// least squares fit of timings[i] ~ a * operations + b * limbOperations, each sample weighted by 1/timings[i]
+		// such that the small instances are not dominated by the large ones
+		double aa = 0, ab = 0, bb = 0, at = 0, bt = 0;
+		for(size_t i = 0; i < timings.size(); ++i) {
+			const double weight = 1.0 / std::max(timings[i], 1e-6);
+			const double a = estimates[i].operations * 1e-9 * weight;
+			const double b = estimates[i].limbOperations * 1e-9 * weight;
+			const double t = timings[i] * weight;
+			aa += a*a; ab += a*b; bb += b*b; at += a*t; bt += b*t;
+		}
+		CostModel model;
+		const double determinant = aa*bb - ab*ab;
+		if(determinant > 0) {
+			model.nanosPerOperation = (at*bb - bt*ab) / determinant;
+			model.nanosPerLimb = (aa*bt - ab*at) / determinant;
+		}
+		if(determinant <= 0 || model.nanosPerOperation < 0 || model.nanosPerLimb < 0) { // fall back to a cost proportional to the limbs
+			model.nanosPerOperation = 0;
+			model.nanosPerLimb = bb > 0 ? bt / bb : CostModel().nanosPerLimb;
+		}
+		return model;
+	}
+
+}//namespace
@@ -0,0 +1,81 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file cost_estimate.hpp
+ * @brief Predicts the running time and the memory of a generator from its SweepPlan
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef COST_ESTIMATE_HPP
+#define COST_ESTIMATE_HPP
+#include "sweep_plan.hpp"
+
+namespace IntervalPartition {
+
+	/**
+	 * Cost of one arithmetic operation on rational coefficients, i.e., a multiplication followed by an addition.
+	 * An operation on coefficients of l limbs takes nanosPerOperation + l * nanosPerLimb nanoseconds.
+	 * The defaults were fitted on a current desktop machine, calibrateCostModel fits them on the running one.
+	 */
+	struct CostModel {
+		double nanosPerOperation = 170;
+		double nanosPerLimb = 80;
+	};
+
+	/**
+	 * The predicted cost of computing one level of the sweep
+	 */
+	struct LevelCost {
+		size_t intervals; //!< the number of pieces of this level
+		size_t degree; //!< the degree of its polynomials
+		size_t coefficientBits; //!< an upper estimate of the bits of numerator and denominator of a coefficient
+		double operations; //!< the number of arithmetic operations to compute this level
+		double limbOperations; //!< operations weighted by the limbs of their operands
+		size_t bytes; //!< the memory of the piecewise-defined polynomial of this level
+	};
+
+	/**
+	 * The predicted cost of the sequential generator executing a plan
+	 */
+	struct CostEstimate {
+		vektor<LevelCost> levels;
+		double operations = 0;
+		double limbOperations = 0;
+		size_t peakBytes = 0; //!< the plan, the Faulhaber sums of the previous level, and the two levels in progress
+
+		/** @return the predicted running time under model */
+		double seconds(const CostModel& model) const {
+			return (operations * model.nanosPerOperation + limbOperations * model.nanosPerLimb) * 1e-9;
+		}
+	};
+
+	/**
+	 * Estimates the cost of generateIntervalPartition from the plan alone, in time linear in the number of pieces.
+	 * No polynomial is computed.
+	 */
+	CostEstimate estimateCost(const SweepPlan& plan);
+
+	/**
+	 * Runs the sequential generator on instances of growing size for about the given time budget,
+	 * and fits the constants of the model to the measured running times by least squares.
+	 */
+	CostModel calibrateCostModel(const double seconds = 2.0);
+
+}//ns
+#endif//guard
@@ -1,3 +1,4 @@
 #include "definitions.hpp"
 
 extern const Z Z_zero = 0;
+extern const IB IB_zero = 0;
@@ -27,6 +27,7 @@
 #define DEFINITIONS_HPP
 
 #include <vector>
+#include <cstdint>
 #include <gmpxx.h>
 #include <iostream>
 #include "checked_vector.hpp"
@@ -37,11 +38,12 @@
 
 typedef mpq_class Q;
 typedef mpz_class Z;
-typedef mpz_class IB;
+typedef uint64_t IB; //!< interval bounds are sums of unsigned int bounds, so they fit into a machine word
 //template <typename T> using vektor = std::vector<T>;
 template <typename T> using vektor = IntervalPartition::checked_vector<T>;
 
 extern const Z Z_zero;
+extern const IB IB_zero;
 
 #ifndef NDEBUG
 #include "debug.hpp"
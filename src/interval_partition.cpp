@@ -20,35 +20,22 @@
 #include "binomial.hpp"
 #include "util.hpp"
 #include "sum_from_zero_cacher.hpp"
+#include "stats.hpp"
+#include <algorithm>
 #include <numeric>
 
 
 namespace IntervalPartition
 {
 
-	/** 
-	 * Returns the witness interval's upper bound
-	 * This function is used to prevent out-of-bounds (reading over intervalbound)
-	 * 
-	 * @param witness_index an index part of intervalbounds
-	 * @param intervalbounds a set of numbers that shall represent the upper bounds of a set of piecewise disjoint intervals covering Z
-	 * 
-	 * @return an entry of intervalbounds
-	 */
-	const IB& get_witness(size_t witness_index, const vektor<IB>& intervalbounds) {
-		if(witness_index == 0) return Z_zero;
-		if(witness_index > intervalbounds.size()) return intervalbounds[intervalbounds.size()-1];
-		return intervalbounds[witness_index-1];
-	}
-
-
 	/** 
 	 * Computes for the interval [witness_left_index, witness_right_index] the summation considered in Theorem 4.7
 	 * of the piecewise-defined polynomial intervalledPolynom, where dimensional_upper_bound is the current considered bound (i_{n+1})
 	 * 
 	 * @param dimensional_upper_bound $i_{k+1}$ of the dimensional_upper_bounds under consideration
 	 * @param intervalbounds the current bounds of the interval of the intervalledPolynom
-	 * @param intervalledPolynom the piecewise-defined polynomial over which to sum
+	 * @param sums the Faulhaber sums of the pieces of intervalledPolynom, addressed by their index
+	 * @param intervalledPolynom the piecewise-defined polynomial over which to sum, its i-th piece belongs to intervalbounds[i]
 	 * @param witness_left_index the left border of intervalbounds to sum (+1)
 	 * @param witness_right_index the right border of intervalbounds to sum (+1)
 	 * 
@@ -58,7 +45,7 @@ namespace IntervalPartition
 	Polynom sumPolynomialOverWitnesses
 	( const unsigned int& dimensional_upper_bound // dimensional_upper_bounds[k]
 	, const vektor<IB>& intervalbounds 
-	, const std::function<const Polynom&(const Polynom&)>& SumFromZeroToUpper
+	, const SumFromZeroTable& sums
 	, const IntervalledPolynom& intervalledPolynom
 	, const size_t& witness_left_index
 	, const size_t& witness_right_index
@@ -81,10 +68,12 @@ namespace IntervalPartition
 					DCHECK_GT(witness_left_index, 0);
 					const IB& current_intervalbound = intervalbounds[witness_left_index-1]; //!
 					DVLOG(2) << "Intervalbound: " << current_intervalbound;
-					const Polynom& toSum = intervalledPolynom.at(current_intervalbound);
-					const Polynom& upper = SumFromZeroToUpper(toSum);
-					const Polynom lower = sumFromZeroToZMinusGamma(toSum, dimensional_upper_bound+1, SumFromZeroToUpper, Binomial::b);
-					Polynom together = upper - lower;
+					const Polynom& toSum = intervalledPolynom.piece(witness_left_index-1);
+					const Polynom& summedUp = sums[witness_left_index-1];
+					Polynom together;
+					sumFromZeroToZMinusGamma(together, toSum, dimensional_upper_bound+1, PrecomputedSum { summedUp }, Binomial::b);
+					together.negate();
+					together += summedUp;
 					DVLOG(2) << "Together Sum: " << together;
 					return together;
 				} else {
@@ -95,18 +84,14 @@ namespace IntervalPartition
 					 * \f$ \sum_{l= z - i_k }^{t} p(k) \f$
 					 * where p is intervallPolynom.at(Left-Witness)
 					 */
-					const Polynom lower_sum([&] () -> Polynom
-					{
-						if(witness_left_index < 1 || witness_left_index-1 >= intervalbounds.size()) {
-							Polynom lower_sum_pol(Polynom::zero);
-							return lower_sum_pol;
-						}
+					thread_local Polynom lower_sum; //!< scratch buffer, the memory of its coefficients is reused by every call of this thread
+					const bool has_lower_sum = witness_left_index >= 1 && witness_left_index-1 < intervalbounds.size();
+					if(has_lower_sum) {
 						const IB& lower_sum_intervalbound = intervalbounds[witness_left_index-1]; //!
 						DVLOG(2) << "Lower Interval: " << lower_sum_intervalbound;
-						Polynom lower_sum_pol = sumFromZMinusGammaToUpper(intervalledPolynom.at(lower_sum_intervalbound), dimensional_upper_bound, lower_sum_intervalbound, SumFromZeroToUpper, Binomial::b);
-						return lower_sum_pol;
-					}());
-					DVLOG(2) << "Lower Sum: " << lower_sum;
+						sumFromZMinusGammaToUpper(lower_sum, intervalledPolynom.piece(witness_left_index-1), dimensional_upper_bound, lower_sum_intervalbound, PrecomputedSum { sums[witness_left_index-1] }, Binomial::b);
+						DVLOG(2) << "Lower Sum: " << lower_sum;
+					}
 					
 					/**
 					 * Let:
@@ -114,27 +99,12 @@ namespace IntervalPartition
 					 * u: witness_right_index -1 (upper bound)
 					 *
 					 * Calculate constant sum of intervalledPolynom.at(k) over \f$ k \in I^n_j \f$ with \f$ l < j < u \f$
-					 * This range is split up by \f$ \sum_k={s_j}^{t_j} p(x) \f$ for every \f$ l < j < u\$ and $I^n_j = (s_j, t_j) \f$
+					 * This range is split up by \f$ \sum_k={s_j}^{t_j} p(x) \f$ for every \f$ l < j < u\$ and $I^n_j = (s_j, t_j) \f$,
+					 * whose prefix sums are kept by the table of the Faulhaber sums.
 					 */
-					const Z const_sum = ( (witness_left_index > 0 || witness_right_index > 0) && witness_right_index-witness_left_index > 1) ? [&] () -> Z
-					{
-						Q const_sumq;
-						for(size_t constinterval = witness_left_index; constinterval <= witness_right_index-2; ++constinterval)
-						{
-							if(constinterval >= intervalbounds.size()) break; //!
-							const IB& intervalupper_bound = intervalbounds[constinterval]; //!
-							const Polynom& summedUp = SumFromZeroToUpper(intervalledPolynom.at(intervalupper_bound));
-							const_sumq += summedUp(intervalupper_bound);
-							if(constinterval > 0) //!< if we examine \f$I^n_j\f$ for a j > 0, then we have summed up to much -> subtract interval [0, s_j[
-							{
-								const IB& intervallower_bound = intervalbounds[constinterval-1]; //!
-								const_sumq -= summedUp(intervallower_bound);
-							}
-						}
-						mpq_canonicalize(const_sumq.get_mpq_t());
-						DCHECK_EQ(const_sumq.get_den(), 1);
-						return const_sumq.get_num();
-					}() : 0;
+					const Z const_sum = ( (witness_left_index > 0 || witness_right_index > 0) && witness_right_index-witness_left_index > 1 && witness_left_index < intervalbounds.size())
+						? sums.rangeTotal(witness_left_index, std::min<size_t>(witness_right_index-1, intervalbounds.size()))
+						: 0;
 					DVLOG(2) << "Constant Sum: " << const_sum;
 					DCHECK_GE(const_sum, 0) << "Constant Sum is Negative!"; // Invariant: polynomial is non-negative
 
@@ -146,7 +116,7 @@ namespace IntervalPartition
 					 * \f$ \sum_{k= s}^{z} p(k) \f$
 					 * where p is intervallPolynom.at(Right-Witness)
 					 */
-					const Polynom upper_sum( [&] () -> Polynom
+					Polynom upper_sum( [&] () -> Polynom
 					{
 						if(witness_right_index-1 >= intervalbounds.size()) {
 							Polynom upper_sum_pol(Polynom::zero);
@@ -154,7 +124,7 @@ namespace IntervalPartition
 						}
 						const IB& upper_sum_intervalupper_bound = intervalbounds[witness_right_index-1]; //!
 						DVLOG(2) << "Upper Interval: " << upper_sum_intervalupper_bound;
-						Polynom upper_sum_pol = Polynom(SumFromZeroToUpper(intervalledPolynom.at(upper_sum_intervalupper_bound)));
+						Polynom upper_sum_pol = Polynom(sums[witness_right_index-1]);
 						DVLOG(2) << "upper_sum_pol pre " << upper_sum_pol;
 						if(witness_right_index > 1)
 						{
@@ -168,7 +138,8 @@ namespace IntervalPartition
 					DVLOG(2) << "Upper Sum: " << upper_sum;
 
 					
-					Polynom together = upper_sum + lower_sum;
+					Polynom together(std::move(upper_sum));
+					if(has_lower_sum) together += lower_sum;
 					together[0] += const_sum;
 					DVLOG(2) << "Together Sum: " << together;
 					return together;
@@ -181,22 +152,26 @@ namespace IntervalPartition
 	 * Generates an intervalled polynom based on the interval bounds given as parameter
 	 * @pre \code length(dimensional_upper_bounds) == dimensions \endcode has to hold.
 	 */
-	IntervalledPolynom generateIntervalPartition(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry)
+	IntervalledPolynom generateIntervalPartition(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry, vektor<IntervalledPolynom>* levels)
 	{
-		DVLOG(2) << "Interval Partitioning started";
-#ifndef NDEBUG
-		for(size_t i = 0; i < dimensions; ++i) {
-			DCHECK_GT(dimensional_upper_bounds[i], 0) << "Every dimensional upper bound has to be > 0";
-		}
-#endif
-		// maxdim is only used if useSymmetry to decide the cut-off
-		const size_t maxdim = std::accumulate(dimensional_upper_bounds, dimensional_upper_bounds+dimensions,static_cast<size_t>(0)); 
-		vektor<IB> intervalbounds;
-		SumFromZeroCacher sumcacher; // instead of calling sumFromZeroToUpper each time, we cache its sum.
-		std::function<const Polynom&(const Polynom&)> SumFromZeroToUpper = [&sumcacher] (const Polynom& a) -> const Polynom& { return sumcacher(a);};
+		return generateIntervalPartition(SweepPlan(dimensional_upper_bounds, dimensions, useSymmetry), levels);
+	}
 
+	IntervalledPolynom generateIntervalPartition(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry, SumFromZeroCacher& sumcacher, vektor<IntervalledPolynom>* levels)
+	{
+		return generateIntervalPartition(SweepPlan(dimensional_upper_bounds, dimensions, useSymmetry), sumcacher, levels);
+	}
 
-		intervalbounds.push_back(dimensional_upper_bounds[0]);
+	/**
+	 * @param sumcacher if not null, the Faulhaber sums are looked up in this cache instead of computing them
+	 */
+	static IntervalledPolynom sweep(const SweepPlan& plan, SumFromZeroCacher* sumcacher, vektor<IntervalledPolynom>* levels)
+	{
+		STATS_TIMER(sweep);
+		DVLOG(2) << "Interval Partitioning started";
+		const size_t dimensions = plan.dimensions();
+		const unsigned int* const dimensional_upper_bounds = plan.dimensional_upper_bounds();
+		SumFromZeroTable sums; //!< the Faulhaber sums of the pieces of the previous level, each computed once
 
 		IntervalledPolynom intervalledPolynom;
 		{
@@ -204,135 +179,37 @@ namespace IntervalPartition
 			pol[0] = 1;
 			intervalledPolynom.push_back(dimensional_upper_bounds[0], std::move(pol));
 		}//!< This is exactly the induction base of Theorem 4.7
+		if(levels != nullptr) levels->push_back(intervalledPolynom);
+		STATS_LEVEL(0, 1);
 
 		for(size_t k = 1; k < dimensions; ++k)
 		{
 			DVLOG(2) << "k: " << k;
-
-			vektor<IB> tmp_intervalbounds; //! in this array the interval bounds of the next round (k+1) will be stored
+			const vektor<IB>& intervalbounds = plan.level(k-1).bounds;
+			const SweepPlan::Level& level = plan.level(k);
+			STATS_LEVEL(k, level.bounds.size());
+			STATS_ADD(jobs, level.bounds.size());
 			IntervalledPolynom tmp_intervalledPolynom; //! this will be the polynom of the next round (k+1)
-			vektor<IB> help_intervalbounds;
-			const unsigned int& dimensional_upper_bound = dimensional_upper_bounds[k];
-
-			//if(dimensional_upper_bound > 1) 
-			{ // we do now want a help_intervalbounds-value of 0
-				help_intervalbounds.push_back(dimensional_upper_bound - 1);
-			}
-
-
-			for(const IB& old_intervalbound : intervalbounds)
-				help_intervalbounds.push_back(old_intervalbound + dimensional_upper_bound);
-
+			sums.assign(intervalledPolynom, sumcacher);
 
-			
-			/**
-			 * i : intervalbounds[] index
-			 * j : help_intervalbounds[] index
-			 * witness_right_index, witness_left_index : intervalbounds[] index
-			 * witness_right, witness_left : help_intervalbounds[] value
-			 *
-			 */
-			for(size_t i = 0, j = 0, witness_left_index = 0, witness_right_index = 0; j < help_intervalbounds.size();)
+			for(size_t i = 0; i < level.bounds.size(); ++i)
 			{
-
-				const IB& intervalbound = i < intervalbounds.size() ?  intervalbounds[i] : Z_zero;
-				const IB& help_intervalbound = help_intervalbounds[j];
-				
-				const IB& witness_right = get_witness(witness_right_index, intervalbounds);
-				const IB& witness_left = get_witness(witness_left_index, intervalbounds);
-				if(useSymmetry && witness_left >= maxdim/2) break;
-				DCHECK_LE(witness_left_index, intervalbounds.size()+1);
-				DCHECK_LE(witness_right_index, intervalbounds.size()+1);
-
-				DVLOG(2) << "k: " << k << ", i: " << i << ", j: " << j;
-				if(i < intervalbounds.size()) {
-					/**
-					 * We are examining intervalbounds[i] and help_intervalbounds[j] and pop
-					 * that value which is smaller (popping: increment either i or j)
-					 * If both values are the same, we increment both i and j.
-					 * min(intervalbounds[i], help_intervalbounds[j]) is appended to tmp_intervalbounds
-					 */
-					if(intervalbound < help_intervalbound) {
-						tmp_intervalbounds.push_back(intervalbound);
-						if(witness_right < intervalbound) {
-							++witness_right_index;
-						}
-						if(intervalbound > witness_left + dimensional_upper_bound ) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 1, addiere " << intervalbound;
-						++i;
-					}
-					else if(intervalbound > help_intervalbound)
-					{
-						tmp_intervalbounds.push_back(help_intervalbound);
-						if(witness_right < help_intervalbound) {
-							++witness_right_index;
-						}
-						if(help_intervalbound > witness_left + dimensional_upper_bound) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 2, addiere " << help_intervalbound;
-						++j;
-					}
-					else
-					{
-						tmp_intervalbounds.push_back(intervalbound);
-						if(intervalbound > witness_right) {
-							++witness_right_index;
-						}
-						if(intervalbound > witness_left + dimensional_upper_bound) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 3, addiere " << intervalbound;
-						++i;
-						++j;
-					}
-				} else {
-					/** We have already taken every element of intervalbounds[]. Because help_intervalbounds[] has some larger values, these have to 
-					 *  be examined:
-					 */
-					tmp_intervalbounds.push_back(help_intervalbound);
-					if(help_intervalbound > witness_right && witness_right_index <= intervalbounds.size()) {
-						++witness_right_index;
-					}
-					if(help_intervalbound > witness_left + dimensional_upper_bound) {
-						++witness_left_index;
-					}
-					DVLOG(2) << "Fall 4, addiere " << help_intervalbound;
-					++j;
-				}
-				DVLOG(2) << "intervalledPolynom: " << intervalledPolynom;
-				DVLOG(2) << "tmp_intervalledPolynom: " << tmp_intervalledPolynom;
-				DVLOG(2) << "Witness: " << "[" << witness_left_index << ", " << witness_right_index << "]";
-				DVLOG(2) << "tmp_intervalbounds: " << tmp_intervalbounds;
-				DVLOG(2) << "intervalbounds: " << intervalbounds;
-				
 				Polynom toAdd(
 						std::move(
 							sumPolynomialOverWitnesses
-							( dimensional_upper_bound
+							( dimensional_upper_bounds[k]
 							, intervalbounds
-							, SumFromZeroToUpper
+							, sums
 							, intervalledPolynom
-							, witness_left_index
-							, witness_right_index)));
-				if(toAdd != Polynom::zero) 
-				tmp_intervalledPolynom.push_back(tmp_intervalbounds.back(), std::move(toAdd));
-				DCHECK_GE(tmp_intervalledPolynom.at(tmp_intervalbounds.back())(tmp_intervalbounds.back()), 0); // Invariant: polynomial is non-negative
+							, level.witnesses[i].left
+							, level.witnesses[i].right)));
+				DCHECK(toAdd != Polynom::zero); // every interval gets a piece, such that pieces can be addressed by the index of their interval
+				tmp_intervalledPolynom.push_back(level.bounds[i], std::move(toAdd));
+				DCHECK_GE(tmp_intervalledPolynom.at(level.bounds[i])(level.bounds[i]), 0); // Invariant: polynomial is non-negative
 			}
 
-#ifndef NDEBUG
-			DCHECK(has_ordering(tmp_intervalbounds, std::greater<IB>())); // Invariant: the numbers of tmp_intervalbounds are strict ascendending
-			for(const auto& ibound : tmp_intervalbounds) { //Invariant: the piecewise-defined polynomial is non-negative.
-				DCHECK_GE(tmp_intervalledPolynom.at(ibound)(ibound), 0);
-			}
-#endif
-
-			intervalbounds.swap(tmp_intervalbounds);
 			intervalledPolynom.swap(tmp_intervalledPolynom);
-
-			DVLOG(2) << "_old_intervals: " << intervalbounds;
+			if(levels != nullptr) levels->push_back(intervalledPolynom);
 		}
 		DVLOG(2) << "Resulting Intervalled Polynom: " << intervalledPolynom;
 #ifndef NDEBUG
@@ -346,7 +223,7 @@ namespace IntervalPartition
 					"for very small z, the upper bounds do not pose any constraint to the distribution of z." 
 					"So the result is the same as for the 'bars and stars' problem.";
 			}
-			if(!useSymmetry) { // there is no point to check for symmetry when we build the polygon only for the lower part
+			if(!plan.symmetric()) { // there is no point to check for symmetry when we build the polygon only for the lower part
 				const size_t& dimensionalSum = std::accumulate(dimensional_upper_bounds, dimensional_upper_bounds+dimensions, static_cast<size_t>(0));
 				for(size_t z = 0; z < dimensionalSum/2; ++z) {
 					DCHECK_EQ(intervalledPolynom(z), intervalledPolynom(dimensionalSum-z)) <<
@@ -355,46 +232,130 @@ namespace IntervalPartition
 			}
 		}
 #endif
+		intervalledPolynom.freeze();
 		return intervalledPolynom;
 	}
 
-IB number_of_interval_partitions(unsigned int* const bounds, size_t bsize, unsigned long z, size_t threads) {
-	if(z == 0) return 1; // z=0 is always one valid configuration
-	if(bsize == 0) return 0; // if z>0 but there are no bounds, there is no valid configuration
-	size_t ones = 0; // number of dimensions with size 1
-	for(size_t i = 0; i < bsize; ++i) {
-		if(bounds[i] == 0) return 0;
-		if(bounds[i] == 1) {
-			bounds[i] = bounds[bsize-1];
-			++ones;
-			--bsize;
-			--i;
-		}
+	IntervalledPolynom generateIntervalPartition(const SweepPlan& plan, vektor<IntervalledPolynom>* levels)
+	{
+		return sweep(plan, nullptr, levels);
 	}
-	if(bsize == 0) {
-		return IntervalPartition::Binomial::b(ones,z);
+
+	IntervalledPolynom generateIntervalPartition(const SweepPlan& plan, SumFromZeroCacher& sumcacher, vektor<IntervalledPolynom>* levels)
+	{
+		return sweep(plan, &sumcacher, levels);
 	}
-	IntervalPartition::IntervalledPolynom intervalledPolynom = threads == 1
-		? IntervalPartition::generateIntervalPartition(bounds, bsize, true)
-		: IntervalPartition::generateParallelIntervalPartition(bounds, bsize, true, threads);
-	const size_t dimensionalSum = std::accumulate(bounds, bounds+bsize, static_cast<size_t>(0))+ones;
+
+Z evaluate_interval_partitions(const IntervalledPolynom& intervalledPolynom, const size_t boundSum, const size_t ones, unsigned long z) {
+	STATS_TIMER(evaluate);
+	const size_t dimensionalSum = boundSum+ones;
+	if(z > dimensionalSum) return 0;
 	if(z > dimensionalSum/2) {
 		z  = dimensionalSum-z;
 	}
-	if(ones == 0) { 
-		Q ret = intervalledPolynom(z);
-		ret.canonicalize();
-		DCHECK_EQ(ret.get_den(),1);
-		return ret.get_num();
+	/**
+	 * The polynomial is only valid up to boundSum/2, but the convolution with the ones 
+	 * may query it up to z > boundSum/2. There, we use the symmetry wrt. boundSum.
+	 */
+	auto mirrored = [&] (size_t x) -> Z {
+		if(x > boundSum) return 0;
+		const Q value = intervalledPolynom(2*x > boundSum ? boundSum-x : x); // canonicalized by the evaluation
+		DCHECK_EQ(value.get_den(),1);
+		return value.get_num();
+	};
+	if(ones == 0) return mirrored(z);
+
+	/**
+	 * We compute \f$ \sum_{k=0}^{\min(z,ones)} {ones \choose k} f(z-k) \f$, where f is the mirrored polynomial.
+	 * The points x = z-k are consecutive, and f is a single polynomial on a run of points that share a piece and a half wrt. the symmetry.
+	 * On a run longer than the degree, the next value of f is obtained from the forward differences
+	 * \f$ f(x), \Delta f(x), ..., \Delta^d f(x) \f$ by d additions of integers, instead of a search and a rational evaluation.
+	 * The binomial coefficients are updated along the way, such that any number of ones is supported.
+	 */
+	const vektor<IB>& intervalbounds = intervalledPolynom.bounds();
+	auto runEnd = [&] (const size_t x) -> size_t { //!< the largest x' such that f is a single polynomial on [x, x']
+		if(2*x <= boundSum) {
+			const auto it = std::lower_bound(intervalbounds.begin(), intervalbounds.end(), x);
+			return it == intervalbounds.end() ? boundSum/2 : std::min<size_t>(*it, boundSum/2);
+		}
+		const auto it = std::lower_bound(intervalbounds.begin(), intervalbounds.end(), boundSum-x); // the mirrored point decreases with x
+		return it == intervalbounds.begin() ? boundSum : boundSum - (*(it-1)+1);
+	};
+	const size_t sum_bound = std::min<size_t>(z, ones);
+	const size_t last = std::min<size_t>(z, boundSum); // f vanishes beyond boundSum
+	Z binomial; //!< \f$ {ones \choose z-x} \f$
+	mpz_bin_uiui(binomial.get_mpz_t(), ones, sum_bound);
+	Z ret = 0;
+	vektor<Z> differences;
+	for(size_t x = z-sum_bound; x <= last;) {
+		const size_t end = std::min(runEnd(x), last);
+		DCHECK_GE(end, x);
+		const size_t degree = std::max<size_t>(1, intervalledPolynom.at(static_cast<IB>(2*x > boundSum ? boundSum-x : x)).size())-1;
+		const bool walk = end-x > degree; // otherwise, computing the differences costs more than evaluating every point
+		if(walk) {
+			differences.resize(degree+1);
+			for(size_t j = 0; j <= degree; ++j) differences[j] = mirrored(x+j);
+			for(size_t l = 1; l <= degree; ++l) {
+				for(size_t j = degree; j >= l; --j) differences[j] -= differences[j-1];
+			}
+		}
+		for(; x <= end; ++x) {
+			if(walk) {
+				mpz_addmul(ret.get_mpz_t(), binomial.get_mpz_t(), differences[0].get_mpz_t());
+				for(size_t j = 0; j < degree; ++j) differences[j] += differences[j+1];
+			} else {
+				mpz_addmul(ret.get_mpz_t(), binomial.get_mpz_t(), mirrored(x).get_mpz_t());
+			}
+			const size_t k = z-x;
+			if(k > 0) { // {ones \choose k-1} = {ones \choose k} * k / (ones-k+1)
+				mpz_mul_ui(binomial.get_mpz_t(), binomial.get_mpz_t(), k);
+				mpz_divexact_ui(binomial.get_mpz_t(), binomial.get_mpz_t(), ones-k+1);
+			}
+		}
 	}
-	Q ret = 0;
-	const size_t sum_bound = std::min(z, ones);
-	for(size_t k = 0; k <= sum_bound; ++k) {
-		ret += IntervalPartition::Binomial::b(ones,k) * intervalledPolynom(z-k);
+	return ret;
+}
+
+	/** 
+	 * Strips the dimensions with bound 1, builds the polynomial of the remaining dimensions with build,
+	 * and convolves it with the binomial coefficients of the stripped dimensions.
+	 * 
+	 * @param build function with signature \code IntervalledPolynom build(const unsigned int* bounds, size_t dimensions) \endcode
+	 *  that is called with useSymmetry semantics, i.e., the returned polynomial is only valid up to the half of the sum of bounds.
+	 */
+	template<class t_Build>
+	Z countWithBuilder(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, unsigned long z, const t_Build& build) {
+		if(z == 0) return 1; // z=0 is always one valid configuration
+		if(dimensions == 0) return 0; // if z>0 but there are no bounds, there is no valid configuration
+		vektor<unsigned int> bounds; // the bounds larger than one, the caller's array is left untouched
+		bounds.reserve(dimensions);
+		size_t ones = 0; // number of dimensions with size 1
+		for(size_t i = 0; i < dimensions; ++i) {
+			if(dimensional_upper_bounds[i] == 0) return 0;
+			if(dimensional_upper_bounds[i] == 1) ++ones;
+			else bounds.push_back(dimensional_upper_bounds[i]);
+		}
+		if(bounds.empty()) {
+			Z ret;
+			mpz_bin_uiui(ret.get_mpz_t(), ones, z);
+			return ret;
+		}
+		const size_t boundSum = std::accumulate(bounds.begin(), bounds.end(), static_cast<size_t>(0));
+		return evaluate_interval_partitions(build(bounds.data(), bounds.size()), boundSum, ones, z);
 	}
-	ret.canonicalize();
-	DCHECK_EQ(ret.get_den(),1);
-	return ret.get_num();
+
+Z number_of_interval_partitions(const unsigned int* const bounds, size_t bsize, unsigned long z, size_t threads) {
+	return countWithBuilder(bounds, bsize, z, [threads] (const unsigned int* const b, const size_t dimensions) {
+		return threads == 1
+			? IntervalPartition::generateIntervalPartition(b, dimensions, true)
+			: IntervalPartition::generateParallelIntervalPartition(b, dimensions, true, threads);
+		});
+}
+
+Z number_of_interval_partitions(const unsigned int* const bounds, size_t bsize, unsigned long z, SumFromZeroCacher& sumcacher) {
+	return countWithBuilder(bounds, bsize, z, [&sumcacher] (const unsigned int* const b, const size_t dimensions) {
+		return IntervalPartition::generateIntervalPartition(b, dimensions, true, sumcacher);
+		});
 }
 
 
@@ -26,22 +26,45 @@
 #ifndef INTERVALL_PARTITION
 #define INTERVALL_PARTITION
 #include "intervalled_polynom.hpp"
+#include "sweep_plan.hpp"
 
 /**
  * Ordered Integer Partition with Upper Bounds Library
  */
 namespace IntervalPartition {
+	class SumFromZeroCacher;
+
 	/** 
 	 * Computes the number of interval partitions with upper bounds for a target value z
 	 * 
-	 * @param dimensional_upper_bounds The upper bounds. Note that each value has to be strictly larger than 0.
-	 * Otherwise, please drop this dimension!
+	 * @param dimensional_upper_bounds The upper bounds. A bound of 0 yields 0 partitions for any z > 0.
+	 * The array is neither copied nor modified.
 	 * @param dimensions The length of dimensional_upper_bounds
 	 * @param z the target value
 	 * @param threads number of threads to spawn. If threads == 1, then it will run the seqential algorithm.
 	 *
 	 */
-	IB number_of_interval_partitions(unsigned int* const dimensional_upper_bounds, size_t dimensions, unsigned long z, size_t threads);
+	Z number_of_interval_partitions(const unsigned int* const dimensional_upper_bounds, size_t dimensions, unsigned long z, size_t threads);
+
+	/** 
+	 * @see number_of_interval_partitions
+	 * Runs the sequential algorithm with a cache that is kept alive by the caller,
+	 * such that the Faulhaber sums computed for a query are reused by the following queries.
+	 * A cache must not be shared by multiple threads.
+	 */
+	Z number_of_interval_partitions(const unsigned int* const dimensional_upper_bounds, size_t dimensions, unsigned long z, SumFromZeroCacher& sumcacher);
+
+	/** 
+	 * Evaluates a piecewise-defined polynomial built with useSymmetry at z, 
+	 * after adding ones further dimensions with bound 1.
+	 * This is the second half of number_of_interval_partitions, used to answer many queries with the same polynomial.
+	 * 
+	 * @param intervalledPolynom the result of generateIntervalPartition or generateParallelIntervalPartition with useSymmetry
+	 * @param boundSum the sum of the bounds that intervalledPolynom was built from
+	 * @param ones the number of additional dimensions with bound 1
+	 * @param z the target value
+	 */
+	Z evaluate_interval_partitions(const IntervalledPolynom& intervalledPolynom, const size_t boundSum, const size_t ones, unsigned long z);
 
 	/** 
 	 * Returns a piecewise-defined polynomial that evaluates for a given integer z the number of partitions of z.
@@ -52,9 +75,29 @@ namespace IntervalPartition {
 	 * @param useSymmetry Drops the validity bounds that do not intersect with the first half of the support of the final polynomial.
 	 *  Note that the solution can still be reconstructed as it is point symmetic at exactly this position.
 	 * 
+	 * @param levels if not null, the piecewise-defined polynomial of every prefix \f$ i_0, ..., i_k \f$ is appended to levels,
+	 *  such that levels[k] counts the partitions into the first k+1 dimensions.
+	 * 
 	 * @return A polynom that answers the integer partition problem for any z in linear time.
 	 */
-	IntervalledPolynom generateIntervalPartition(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry);
+	IntervalledPolynom generateIntervalPartition(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry, vektor<IntervalledPolynom>* levels = nullptr);
+
+	/**
+	 * @see generateIntervalPartition
+	 * @param sumcacher a cache of Faulhaber sums that is kept alive by the caller across multiple calls
+	 */
+	IntervalledPolynom generateIntervalPartition(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry, SumFromZeroCacher& sumcacher, vektor<IntervalledPolynom>* levels = nullptr);
+	/**
+	 * @see generateIntervalPartition
+	 * Executes a plan built beforehand, such that the planning cost is paid once per set of bounds.
+	 * The Faulhaber sum of every piece of a level is computed once and addressed by the index of its interval.
+	 */
+	IntervalledPolynom generateIntervalPartition(const SweepPlan& plan, vektor<IntervalledPolynom>* levels = nullptr);
+	/**
+	 * @see generateIntervalPartition
+	 * Looks up the Faulhaber sums of every level in sumcacher, such that following calls reuse them.
+	 */
+	IntervalledPolynom generateIntervalPartition(const SweepPlan& plan, SumFromZeroCacher& sumcacher, vektor<IntervalledPolynom>* levels = nullptr);
 	/**
 	 * @see generateIntervalPartition
 	 * @param threads number of threads to use 
@@ -63,9 +106,13 @@ namespace IntervalPartition {
 	 */
 	IntervalledPolynom generateParallelIntervalPartition(const unsigned int* const dimensional_upper_bounds, 
 			const size_t dimensions, bool useSymmetry, 	const size_t numthreads);
-
-	/** Internal Usage **/
-	const IB& get_witness(size_t witness_index, const vektor<IB>& intervalbounds);
+	/**
+	 * @see generateParallelIntervalPartition
+	 * Executes a plan built beforehand. All jobs are known from the plan before the first one runs.
+	 * @param jobSeconds if not null, jobSeconds[k][i] receives the wall time of the job computing the i-th interval of level k.
+	 *  A job waiting for a piece of the previous level includes the waiting time, unless numthreads is 1.
+	 */
+	IntervalledPolynom generateParallelIntervalPartition(const SweepPlan& plan, const size_t numthreads, vektor<vektor<double>>* jobSeconds = nullptr);
 
 
 }
@@ -0,0 +1,204 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "interval_partition_c.h"
+#include "interval_partition.hpp"
+#include "sum_from_zero_cacher.hpp"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+using namespace IntervalPartition;
+
+struct ip_solver {
+	size_t threads;
+	vektor<std::unique_ptr<SumFromZeroCacher>> cachers; //!< one cache per worker thread, kept across calls
+};
+
+namespace {
+
+	int write(const Z& value, ip_decimal* result) {
+		const size_t required = mpz_sizeinbase(value.get_mpz_t(), 10) + 2; // sign and NUL
+		if(result->buffer == nullptr || result->capacity < required) {
+			result->length = required;
+			return result->status = IP_BUFFER_TOO_SMALL;
+		}
+		mpz_get_str(result->buffer, 10, value.get_mpz_t());
+		result->length = std::strlen(result->buffer);
+		return result->status = IP_OK;
+	}
+
+	int write(const Z& value, ip_words* result) {
+		const size_t required = value == 0 ? 0 : (mpz_sizeinbase(value.get_mpz_t(), 2) + 63)/64;
+		if(required > 0 && (result->words == nullptr || result->capacity < required)) {
+			result->count = required;
+			return result->status = IP_BUFFER_TOO_SMALL;
+		}
+		size_t count = 0;
+		if(required > 0) mpz_export(result->words, &count, -1, sizeof(uint64_t), 0, 0, value.get_mpz_t());
+		result->count = count;
+		return result->status = IP_OK;
+	}
+
+	template<class t_Result>
+	int fail(t_Result* result, int status) {
+		if(result != nullptr) result->status = status;
+		return status;
+	}
+
+	bool valid(const ip_problem* problem) {
+		return problem != nullptr && (problem->dimensions == 0 || problem->bounds != nullptr);
+	}
+
+	template<class t_Result>
+	int count(ip_solver* solver, const ip_problem* problem, unsigned long z, t_Result* result) {
+		if(solver == nullptr || result == nullptr || !valid(problem)) return fail(result, IP_INVALID_ARGUMENT);
+		try {
+			return write(solver->threads > 1
+					? number_of_interval_partitions(problem->bounds, problem->dimensions, z, solver->threads)
+					: number_of_interval_partitions(problem->bounds, problem->dimensions, z, *solver->cachers[0]),
+					result);
+		} catch(...) {
+			return fail(result, IP_ERROR);
+		}
+	}
+
+	/**
+	 * Distributes the problems on the workers of the solver, each using its own cache
+	 */
+	template<class t_Result>
+	size_t countBatch(ip_solver* solver, const ip_problem* problems, const unsigned long* z, size_t count, t_Result* results) {
+		if(results == nullptr) return count;
+		if(solver == nullptr || (count > 0 && (problems == nullptr || z == nullptr))) {
+			for(size_t k = 0; k < count; ++k) fail(results+k, IP_INVALID_ARGUMENT);
+			return count;
+		}
+		std::atomic<size_t> next(0);
+		std::atomic<size_t> failures(0);
+		auto worker = [&] (SumFromZeroCacher& sumcacher) {
+			for(size_t k = next++; k < count; k = next++) {
+				int status;
+				if(!valid(problems+k)) status = fail(results+k, IP_INVALID_ARGUMENT);
+				else try {
+					status = write(number_of_interval_partitions(problems[k].bounds, problems[k].dimensions, z[k], sumcacher), results+k);
+				} catch(...) {
+					status = fail(results+k, IP_ERROR);
+				}
+				if(status != IP_OK) ++failures;
+			}
+		};
+		const size_t numthreads = std::min(solver->threads, count);
+		vektor<std::thread> threads; // outside of the try, such that no joinable thread is destroyed while unwinding
+		try {
+			threads.reserve(numthreads); // a push_back must not reallocate after its thread was started
+			for(size_t i = 1; i < numthreads; ++i)
+				threads.push_back(std::thread(worker, std::ref(*solver->cachers[i])));
+			worker(*solver->cachers[0]);
+			for(auto& thread : threads) thread.join();
+		} catch(...) { // could not spawn a thread, the started threads finish first, and this thread solves the remaining problems
+			for(auto& thread : threads) if(thread.joinable()) thread.join();
+			worker(*solver->cachers[0]);
+		}
+		return failures;
+	}
+
+	/**
+	 * Builds the polynomial of the problem once and evaluates it at every z
+	 */
+	template<class t_Result>
+	size_t countMany(ip_solver* solver, const ip_problem* problem, const unsigned long* z, size_t count, t_Result* results) {
+		if(results == nullptr) return count;
+		if(solver == nullptr || !valid(problem) || (count > 0 && z == nullptr)) {
+			for(size_t k = 0; k < count; ++k) fail(results+k, IP_INVALID_ARGUMENT);
+			return count;
+		}
+		size_t failures = 0;
+		try {
+			vektor<unsigned int> bounds;
+			size_t ones = 0;
+			bool empty = false; //!< some bound is zero, or there are no bounds at all
+			for(size_t i = 0; i < problem->dimensions; ++i) {
+				if(problem->bounds[i] == 0) empty = true;
+				else if(problem->bounds[i] == 1) ++ones;
+				else bounds.push_back(problem->bounds[i]);
+			}
+			empty |= problem->dimensions == 0;
+			const IntervalledPolynom intervalledPolynom = empty || bounds.empty() ? IntervalledPolynom()
+				: solver->threads > 1
+				? generateParallelIntervalPartition(bounds.data(), bounds.size(), true, solver->threads)
+				: generateIntervalPartition(bounds.data(), bounds.size(), true, *solver->cachers[0]);
+			const size_t boundSum = std::accumulate(bounds.begin(), bounds.end(), static_cast<size_t>(0));
+			for(size_t k = 0; k < count; ++k) {
+				int status;
+				try {
+					if(z[k] == 0) status = write(1, results+k);
+					else if(empty) status = write(0, results+k);
+					else if(bounds.empty()) status = write(number_of_interval_partitions(problem->bounds, problem->dimensions, z[k], 1), results+k);
+					else status = write(evaluate_interval_partitions(intervalledPolynom, boundSum, ones, z[k]), results+k);
+				} catch(...) {
+					status = fail(results+k, IP_ERROR);
+				}
+				if(status != IP_OK) ++failures;
+			}
+		} catch(...) {
+			for(size_t k = 0; k < count; ++k) fail(results+k, IP_ERROR);
+			return count;
+		}
+		return failures;
+	}
+}//ns
+
+extern "C" {
+
+ip_solver* ip_solver_create(size_t threads) {
+	try {
+		ip_solver* solver = new ip_solver;
+		solver->threads = std::max<size_t>(1, threads);
+		for(size_t i = 0; i < solver->threads; ++i)
+			solver->cachers.push_back(std::unique_ptr<SumFromZeroCacher>(new SumFromZeroCacher()));
+		return solver;
+	} catch(...) {
+		return nullptr;
+	}
+}
+
+void ip_solver_destroy(ip_solver* solver) {
+	delete solver;
+}
+
+int ip_count_decimal(ip_solver* solver, const ip_problem* problem, unsigned long z, ip_decimal* result) {
+	return count(solver, problem, z, result);
+}
+int ip_count_words(ip_solver* solver, const ip_problem* problem, unsigned long z, ip_words* result) {
+	return count(solver, problem, z, result);
+}
+size_t ip_count_batch_decimal(ip_solver* solver, const ip_problem* problems, const unsigned long* z, size_t count, ip_decimal* results) {
+	return countBatch(solver, problems, z, count, results);
+}
+size_t ip_count_batch_words(ip_solver* solver, const ip_problem* problems, const unsigned long* z, size_t count, ip_words* results) {
+	return countBatch(solver, problems, z, count, results);
+}
+size_t ip_count_many_decimal(ip_solver* solver, const ip_problem* problem, const unsigned long* z, size_t count, ip_decimal* results) {
+	return countMany(solver, problem, z, count, results);
+}
+size_t ip_count_many_words(ip_solver* solver, const ip_problem* problem, const unsigned long* z, size_t count, ip_words* results) {
+	return countMany(solver, problem, z, count, results);
+}
+
+}//extern "C"
@@ -0,0 +1,102 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file interval_partition_c.h
+ * @brief C interface of the library
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * All arrays passed to these functions are owned by the caller. They are neither copied nor modified,
+ * and results are written into buffers provided by the caller.
+ * No function throws; failures are reported by the status codes below.
+ */
+#ifndef INTERVAL_PARTITION_C_H
+#define INTERVAL_PARTITION_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Status codes */
+enum {
+	IP_OK = 0,
+	IP_BUFFER_TOO_SMALL = 1, /**< the result did not fit, the required capacity is reported instead */
+	IP_INVALID_ARGUMENT = 2,
+	IP_ERROR = 3 /**< internal error, e.g., out of memory */
+};
+
+/** Opaque solver. It keeps caches alive across calls and must not be used by multiple threads at once. */
+typedef struct ip_solver ip_solver;
+
+/** An instance with the upper bounds i_0, ..., i_{dimensions-1} */
+typedef struct ip_problem {
+	const unsigned int* bounds;
+	size_t dimensions;
+} ip_problem;
+
+/** Receives a result as a NUL-terminated decimal string */
+typedef struct ip_decimal {
+	char* buffer;
+	size_t capacity; /**< in bytes, including the terminating NUL */
+	size_t length; /**< set to the length of the string without NUL, or to the required capacity on IP_BUFFER_TOO_SMALL */
+	int status;
+} ip_decimal;
+
+/** Receives a result as 64-bit words, least significant word first */
+typedef struct ip_words {
+	uint64_t* words;
+	size_t capacity; /**< in words */
+	size_t count; /**< set to the number of used words (0 for the result 0), or to the required capacity on IP_BUFFER_TOO_SMALL */
+	int status;
+} ip_words;
+
+/**
+ * @param threads the number of threads a batch is distributed on. A single problem is solved by the parallel algorithm if threads > 1.
+ * @return a new solver, or NULL on failure
+ */
+ip_solver* ip_solver_create(size_t threads);
+void ip_solver_destroy(ip_solver* solver);
+
+/** Computes the number of partitions of z for a single problem */
+int ip_count_decimal(ip_solver* solver, const ip_problem* problem, unsigned long z, ip_decimal* result);
+int ip_count_words(ip_solver* solver, const ip_problem* problem, unsigned long z, ip_words* result);
+
+/**
+ * Computes results[k] for problems[k] and z[k] for every 0 <= k < count.
+ * @return the number of results whose status is not IP_OK
+ */
+size_t ip_count_batch_decimal(ip_solver* solver, const ip_problem* problems, const unsigned long* z, size_t count, ip_decimal* results);
+size_t ip_count_batch_words(ip_solver* solver, const ip_problem* problems, const unsigned long* z, size_t count, ip_words* results);
+
+/**
+ * Computes results[k] for the same problem and z[k] for every 0 <= k < count.
+ * The piecewise-defined polynomial of the problem is built only once.
+ * @return the number of results whose status is not IP_OK
+ */
+size_t ip_count_many_decimal(ip_solver* solver, const ip_problem* problem, const unsigned long* z, size_t count, ip_decimal* results);
+size_t ip_count_many_words(ip_solver* solver, const ip_problem* problem, const unsigned long* z, size_t count, ip_words* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INTERVAL_PARTITION_C_H */
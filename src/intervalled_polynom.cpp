@@ -17,7 +17,10 @@
  */
 #include "intervalled_polynom.hpp"
 #include "polynom.hpp"
+#include "sum_from_zero_to_upper.hpp"
 #include <glog/logging.h>
+#include <algorithm>
+#include <numeric>
 #include "util.hpp"
 
 namespace IntervalPartition {
@@ -48,24 +51,149 @@ bool IntervalledPolynom::operator==(IntervalledPolynom& o) {
 	}
 	return true;
 }
-const Polynom& IntervalledPolynom::at(const IB& point) const
+namespace {
+	/**
+	 * Fills the Eytzinger array by an in-order traversal of the implicit tree rooted at node
+	 */
+	size_t buildEytzinger(const vektor<IB>& sorted, vektor<IB>& eytzinger, vektor<size_t>& rank, size_t index, const size_t node) {
+		if(node >= eytzinger.size()) return index;
+		index = buildEytzinger(sorted, eytzinger, rank, index, 2*node);
+		eytzinger[node] = sorted[index];
+		rank[node] = index++;
+		return buildEytzinger(sorted, eytzinger, rank, index, 2*node+1);
+	}
+}
+
+void IntervalledPolynom::freeze()
 {
-	if(point < 0) return Polynom::zero;
+	if(intervalbounds.empty()) return;
+	eytzinger.assign(intervalbounds.size()+1, 0);
+	eytzingerRank.assign(intervalbounds.size()+1, 0);
+	buildEytzinger(intervalbounds, eytzinger, eytzingerRank, 0, 1);
+}
+
+size_t IntervalledPolynom::locate(const IB& point) const
+{
+	if(frozen()) {
+		const size_t n = eytzinger.size()-1;
+		const IB* const tree = eytzinger.data();
+		size_t k = 1;
+		while(k <= n) {
+			__builtin_prefetch(tree + std::min(16*k, n)); // the 16 descendants four levels below are contiguous; clamped, since a pointer past the end is undefined
+			k = 2*k + (tree[k] < point);
+		}
+		k >>= __builtin_ffsll(~k); // undo the right turns after the last left turn, which was the lower bound
+		if(k == 0) return intervalbounds.size();
+		DCHECK_GE(intervalbounds[eytzingerRank[k]], point);
+		return eytzingerRank[k];
+	}
 	DVLOG(2) <<  "Search " << point << " in " << intervalbounds;
-	vektor<IB>::const_iterator it = lower_bound(intervalbounds.begin(), intervalbounds.end(), point);
-	if(it != intervalbounds.end() && *it >= point) {
-		const size_t distance = std::distance(intervalbounds.begin(),it);
-		DVLOG(2) << "Found " << intervalbounds[distance] << "->" << polynoms[distance];
-		return polynoms[distance];
+	return std::distance(intervalbounds.begin(), lower_bound(intervalbounds.begin(), intervalbounds.end(), point));
+}
+
+const Polynom& IntervalledPolynom::at(const IB& point) const
+{
+	const size_t index = locate(point);
+	if(index < intervalbounds.size()) {
+		DVLOG(2) << "Found " << intervalbounds[index] << "->" << polynoms[index];
+		return polynoms[index];
 	}
 	DVLOG(2) << "Search failed !";
 	return Polynom::zero;
 }
 
+const Polynom& IntervalledPolynom::at(const Z& point) const
+{
+	if(point < 0 || mpz_sizeinbase(point.get_mpz_t(), 2) > 8*sizeof(IB)) return Polynom::zero; // beyond any interval bound
+	IB value = 0;
+	mpz_export(&value, nullptr, -1, sizeof(IB), 0, 0, point.get_mpz_t());
+	return at(value);
+}
+
 Q IntervalledPolynom::operator()(const Z& x) const
 {
 	return at(x)(x);
 }
+Q IntervalledPolynom::operator()(const IB& x) const
+{
+	return at(x)(Q(x));
+}
+void IntervalledPolynom::buildPrefixSums()
+{
+	prefixsums.resize(polynoms.size());
+	intervaltotals.resize(polynoms.size());
+	for(size_t i = 0; i < polynoms.size(); ++i) {
+		prefixsums[i] = sumFromZeroToUpper(polynoms[i]);
+		if(i > 0) prefixsums[i][0] += intervaltotals[i-1] - prefixsums[i](intervalbounds[i-1]);
+		intervaltotals[i] = prefixsums[i](intervalbounds[i]);
+	}
+}
+
+Q IntervalledPolynom::prefix_sum(const IB& z) const
+{
+	DCHECK(hasPrefixSums() || polynoms.empty());
+	const size_t index = locate(z);
+	if(index == intervalbounds.size()) return total_sum();
+	return prefixsums[index](Q(z));
+}
+
+Q IntervalledPolynom::prefix_sum(const Z& z) const
+{
+	if(z < 0) return 0;
+	if(mpz_sizeinbase(z.get_mpz_t(), 2) > 8*sizeof(IB)) return total_sum(); // beyond any interval bound
+	IB value = 0;
+	mpz_export(&value, nullptr, -1, sizeof(IB), 0, 0, z.get_mpz_t());
+	return prefix_sum(value);
+}
+
+Q IntervalledPolynom::range_sum(const IB& z1, const IB& z2) const
+{
+	if(z2 < z1) return 0;
+	if(z1 == 0) return prefix_sum(z2);
+	Q ret = prefix_sum(z2) - prefix_sum(z1-1);
+	STATS_TIMER(canonicalize);
+	mpq_canonicalize(ret.get_mpq_t());
+	return ret;
+}
+
+namespace {
+	/**
+	 * @return the smallest z in [low, high] with prefix(z) >= q, where prefix is non-decreasing on [low, high] and prefix(high) >= q
+	 */
+	IB searchInterval(const Polynom& prefix, const Q& q, IB low, IB high) {
+		while(low < high) {
+			const IB mid = low + (high-low)/2;
+			if(prefix(Q(mid)) >= q) high = mid;
+			else low = mid+1;
+		}
+		return low;
+	}
+}
+
+IB IntervalledPolynom::quantile(const Q& q) const
+{
+	DCHECK(hasPrefixSums());
+	DCHECK_LE(q, total_sum());
+	const size_t index = std::distance(intervaltotals.begin(), std::lower_bound(intervaltotals.begin(), intervaltotals.end(), q));
+	DCHECK_LT(index, intervalbounds.size());
+	return searchInterval(prefixsums[index], q, index == 0 ? 0 : intervalbounds[index-1]+1, intervalbounds[index]);
+}
+
+void IntervalledPolynom::quantiles(const Q* qs, const size_t size, IB* zs) const
+{
+	DCHECK(hasPrefixSums());
+	vektor<size_t> order(size);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&] (const size_t a, const size_t b) { return qs[a] < qs[b]; });
+	size_t index = 0;
+	for(const size_t& position : order) {
+		const Q& q = qs[position];
+		DCHECK_LE(q, total_sum());
+		while(intervaltotals[index] < q) ++index;
+		zs[position] = searchInterval(prefixsums[index], q, index == 0 ? 0 : intervalbounds[index-1]+1, intervalbounds[index]);
+	}
+}
+
 /*
 void IntervalledPolynom::push_back(const IB& intervalbound, const Polynom& polynom)
 {
@@ -77,11 +205,23 @@ void IntervalledPolynom::push_back(const IB& intervalbound, Polynom&& polynom)
 {
 	intervalbounds.push_back(intervalbound);
 	polynoms.push_back(std::move(polynom));
+	if(frozen()) {
+		vektor<IB>().swap(eytzinger);
+		vektor<size_t>().swap(eytzingerRank);
+	}
+	if(hasPrefixSums()) {
+		vektor<Polynom>().swap(prefixsums);
+		vektor<Q>().swap(intervaltotals);
+	}
 }
 void IntervalledPolynom::swap(IntervalledPolynom& o)
 {
 	intervalbounds.swap(o.intervalbounds);
 	polynoms.swap(o.polynoms);
+	eytzinger.swap(o.eytzinger);
+	eytzingerRank.swap(o.eytzingerRank);
+	prefixsums.swap(o.prefixsums);
+	intervaltotals.swap(o.intervaltotals);
 }
 
 
@@ -44,12 +44,83 @@ namespace IntervalPartition {
 		private:
 			vektor<IB> intervalbounds;
 			vektor<Polynom> polynoms;
+			vektor<IB> eytzinger; //!< intervalbounds in Eytzinger order (1-based), empty if not frozen
+			vektor<size_t> eytzingerRank; //!< eytzingerRank[k] is the index of eytzinger[k] in intervalbounds
+			vektor<Polynom> prefixsums; //!< prefixsums[i](y) is the sum of this polynomial over [0, y] for y in the i-th interval, empty if not built
+			vektor<Q> intervaltotals; //!< intervaltotals[i] is the sum of this polynomial over [0, intervalbounds[i]], valid if prefixsums is built
+
+			/**
+			 * @return the index of the interval containing point, or the number of intervals if point is beyond the last one
+			 */
+			size_t locate(const IB& point) const;
 		public:
 			const vektor<IB>& bounds() const{ return intervalbounds; }
+			const vektor<Polynom>& polynomials() const{ return polynoms; }
+
+			/**
+			 * @return the polynom of the index-th interval, i.e., the interval ending at bounds()[index]
+			 */
+			const Polynom& piece(const size_t index) const { return polynoms[index]; }
+
+			/**
+			 * Builds a search index over the interval bounds in Eytzinger (BFS) layout.
+			 * The first levels of the implicit search tree share a few cache lines,
+			 * and the search is branch-free with the next levels prefetched.
+			 * The index is dropped on any modification.
+			 */
+			void freeze();
+			bool frozen() const { return !eytzinger.empty(); }
+
+			/**
+			 * Computes the Faulhaber sum of every piece, and offsets it by the totals of the preceding intervals,
+			 * such that prefix_sum and range_sum take \f$ O(\log n + d) \f$ time for pieces of degree d.
+			 * The sums are dropped on any modification.
+			 */
+			void buildPrefixSums();
+			bool hasPrefixSums() const { return !prefixsums.empty(); }
+			/**
+			 * @return the polynom that coincides with the prefix sum of this polynomial on the index-th interval
+			 * @pre buildPrefixSums() was called
+			 */
+			const Polynom& prefixPiece(const size_t index) const { return prefixsums[index]; }
+
+			/**
+			 * Returns \f$ \sum_{t=0}^{z} p(t) \f$, which is 0 for negative z and the sum over all intervals for z beyond the last interval.
+			 * Note that a polynomial built with useSymmetry is only valid up to its middle.
+			 * @pre buildPrefixSums() was called
+			 */
+			Q prefix_sum(const IB& z) const;
+			Q prefix_sum(const Z& z) const;
+			/**
+			 * @return \f$ \sum_{t=z_1}^{z_2} p(t) \f$, which is 0 if \f$ z_2 < z_1 \f$
+			 * @pre buildPrefixSums() was called
+			 */
+			Q range_sum(const IB& z1, const IB& z2) const;
+			/**
+			 * @return the sum over all intervals, i.e., prefix_sum of any point beyond the last interval
+			 * @pre buildPrefixSums() was called
+			 */
+			Q total_sum() const { return intervaltotals.empty() ? Q(0) : intervaltotals.back(); }
+
+			/**
+			 * Returns the smallest z with prefix_sum(z) >= q, for a polynomial that is non-negative on the integers [0, bounds().back()].
+			 * A quantile of the distribution of the counts is obtained by a fraction of total_sum() as q.
+			 * The interval of z is found by a binary search over the sums at the interval bounds,
+			 * then z is found by a binary search inside the interval, on which the prefix sum is a monotone polynomial.
+			 * This takes \f$ O(\log n + d \log \ell) \f$ time, where \f$ \ell \f$ is the length of the interval.
+			 * @pre buildPrefixSums() was called, and q <= total_sum()
+			 */
+			IB quantile(const Q& q) const;
+			/**
+			 * Computes quantile(qs[i]) for every i, and writes it to zs[i].
+			 * The values qs are processed in ascending order, such that the intervals are scanned only once.
+			 */
+			void quantiles(const Q* qs, const size_t size, IB* zs) const;
 
 			/** 
 			 * Returns the polynom that coincides with this polynomial at that given point.
 			 * Takes \f$ O(\log n) \f$ time, where \f$ n \f$ is the number of different intervals.
+			 * Uses the index built by freeze() if available.
 			 * @pre The vector intervalbounds is sorted ascendingly.
 			 * 
 			 * @param point a point of the domain of this polynomial
@@ -57,6 +128,11 @@ namespace IntervalPartition {
 			 * @return Polynom defined at that point
 			 */
 			const Polynom& at(const IB& point) const;
+			/**
+			 * Returns the polynom of an arbitrary integer, which is Polynom::zero for negative points
+			 * and points that do not fit into an interval bound.
+			 */
+			const Polynom& at(const Z& point) const;
 
 			/** 
 			 * Adds for a new interval a polynom on which this polynomial shall coincide with.
@@ -86,6 +162,7 @@ namespace IntervalPartition {
 			 * @return The evaluated value
 			 */
 			Q operator()(const Z& x) const;
+			Q operator()(const IB& x) const;
 			bool operator==(IntervalledPolynom& o);
 
 		friend std::ostream& operator<<(std::ostream& os, const IntervalledPolynom& ip);
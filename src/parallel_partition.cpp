@@ -20,22 +20,29 @@
 #include "intervalled_polynom.hpp"
 #include "sum_from_zero_to_upper.hpp"
 #include "binomial.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <memory>
 #include <iterator>
 #include <queue>
 #include <numeric>
-#include "sum_from_zero_threads.hpp"
+#include "sum_from_zero_cacher.hpp"
 
 namespace IntervalPartition {
 
 	class PiecedPolyAsync {
 		public:
 		std::mutex evalMutex;
+		size_t level = 0; //!< the number of the dimensions minus one, for tracing
 		PiecedPolyAsync(const PiecedPolyAsync&) = delete; // This class is to experimantal to be used for copying...
 		PiecedPolyAsync() = default;
 		Polynom& evaluate(size_t distance) {
 
 			if(evaluated_polynoms[distance] == nullptr) {
+				TRACE_SCOPE(Trace::wait_piece, level, distance);
 				std::lock_guard<std::mutex> guard(evalMutex);
 				if(evaluated_polynoms[distance] != nullptr) return *evaluated_polynoms[distance];
 				try {
@@ -55,12 +62,43 @@ namespace IntervalPartition {
 			vektor<IB> intervalbounds;
 			vektor<std::future<Polynom*>*> polynoms;
 			vektor<Polynom*> evaluated_polynoms;
+			/**
+			 * sums[i] is the Faulhaber sum of the i-th piece, written by the job computing the piece before it sets the piece's future.
+			 * Its size is fixed before the jobs start.
+			 */
+			vektor<Polynom> sums;
+			vektor<Z> totals; //!< totals[i] is the total of the i-th piece over its interval, written together with sums[i]
 			const vektor<IB>& bounds() const{ return intervalbounds; }
 			const Polynom& at(const IB& point);
+			/**
+			 * @return the polynom of the index-th interval, waiting for its computation if necessary
+			 */
+			const Polynom& piece(const size_t index) { return evaluate(index); }
+			/**
+			 * @return the Faulhaber sum of the index-th piece, waiting for its computation if necessary
+			 */
+			const Polynom& summed(const size_t index) {
+				evaluate(index);
+				DCHECK_LT(index, sums.size());
+				return sums[index];
+			}
+			/**
+			 * @return the total of the index-th piece over its interval, waiting for its computation if necessary
+			 */
+			const Z& total(const size_t index) {
+				evaluate(index);
+				DCHECK_LT(index, totals.size());
+				return totals[index];
+			}
 			void push_back(const IB& intervalbound, std::future<Polynom*>&& polynom);
 			void push_back(const IB& intervalbound, Polynom* polynom);
 			void swap(PiecedPolyAsync& o);
-			Q operator()(const Z& x);
+			/**
+			 * Frees all polynomials and futures. Waits for pieces that are still computed.
+			 * @pre no thread reads this piecewise-defined polynomial anymore
+			 */
+			void release();
+			Q operator()(const IB& x);
 			IntervalledPolynom extract() {
 				IntervalledPolynom o;
 				for(size_t i = 0; i < evaluated_polynoms.size(); ++i) {
@@ -80,7 +118,6 @@ std::ostream& operator<<(std::ostream& os, PiecedPolyAsync& ip) {
 }
 
 const Polynom& PiecedPolyAsync::at(const IB& point) {
-	if(point < 0) return Polynom::zero;
 	DVLOG(2) <<  "Search " << point << " in " << intervalbounds;
 	vektor<IB>::const_iterator it = lower_bound(intervalbounds.begin(), intervalbounds.end(), point);
 	if(it != intervalbounds.end() && *it >= point) {
@@ -93,7 +130,7 @@ const Polynom& PiecedPolyAsync::at(const IB& point) {
 	return Polynom::zero;
 }
 
-Q PiecedPolyAsync::operator()(const Z& x) {
+Q PiecedPolyAsync::operator()(const IB& x) {
 	return at(x)(x);
 }
 void PiecedPolyAsync::push_back(const IB& intervalbound, std::future<Polynom*>&& polynom) {
@@ -106,16 +143,30 @@ void PiecedPolyAsync::push_back(const IB& intervalbound, Polynom* polynom) {
 	polynoms.push_back(nullptr);
 	evaluated_polynoms.push_back(polynom);
 }
+void PiecedPolyAsync::release() {
+	std::lock_guard<std::mutex> guard(evalMutex);
+	for(size_t i = 0; i < polynoms.size(); ++i) {
+		if(evaluated_polynoms[i] == nullptr && polynoms[i] != nullptr) evaluated_polynoms[i] = polynoms[i]->get(); // a piece no job has read
+		delete evaluated_polynoms[i];
+		delete polynoms[i];
+	}
+	vektor<IB>().swap(intervalbounds);
+	vektor<std::future<Polynom*>*>().swap(polynoms);
+	vektor<Polynom*>().swap(evaluated_polynoms);
+	vektor<Polynom>().swap(sums);
+	vektor<Z>().swap(totals);
+}
 void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 	intervalbounds.swap(o.intervalbounds);
 	polynoms.swap(o.polynoms);
 	evaluated_polynoms.swap(o.evaluated_polynoms);
+	sums.swap(o.sums);
+	totals.swap(o.totals);
 }
 
 	Polynom* sumParallelPolynomialOverWitnesses
 	( const unsigned int& dimensional_upper_bound // dimensional_upper_bounds[k]
 	, const vektor<IB>& intervalbounds 
-	, const std::function<const Polynom&(const Polynom&)>& SumFromZeroToUpper
 	, PiecedPolyAsync& intervalledPolynom
 	, const size_t& witness_left_index
 	, const size_t& witness_right_index
@@ -138,10 +189,12 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 					DCHECK_GT(witness_left_index, 0);
 					const IB& current_intervalbound = intervalbounds[witness_left_index-1]; //!
 					DVLOG(2) << "Intervalbound: " << current_intervalbound;
-					const Polynom& toSum = intervalledPolynom.at(current_intervalbound);
-					const Polynom& upper = SumFromZeroToUpper(toSum);
-					const Polynom lower = sumFromZeroToZMinusGamma(toSum, dimensional_upper_bound+1, SumFromZeroToUpper, Binomial::b);
-					Polynom* together = new Polynom(upper - lower);
+					const Polynom& toSum = intervalledPolynom.piece(witness_left_index-1);
+					const Polynom& summedUp = intervalledPolynom.summed(witness_left_index-1);
+					Polynom* together = new Polynom();
+					sumFromZeroToZMinusGamma(*together, toSum, dimensional_upper_bound+1, PrecomputedSum { summedUp }, Binomial::b);
+					together->negate();
+					(*together) += summedUp;
 					DVLOG(2) << "Together Sum: " << (*together);
 					return together;
 				} else {
@@ -152,18 +205,14 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 					 * \f$ \sum_{l= z - i_k }^{t} p(k) \f$
 					 * where p is intervallPolynom.at(Left-Witness)
 					 */
-					const Polynom lower_sum([&] () -> Polynom
-					{
-						if(witness_left_index < 1 || witness_left_index-1 >= intervalbounds.size()) {
-							Polynom lower_sum_pol(Polynom::zero);
-							return lower_sum_pol;
-						}
+					thread_local Polynom lower_sum; //!< scratch buffer, the memory of its coefficients is reused by every call of this thread
+					const bool has_lower_sum = witness_left_index >= 1 && witness_left_index-1 < intervalbounds.size();
+					if(has_lower_sum) {
 						const IB& lower_sum_intervalbound = intervalbounds[witness_left_index-1]; //!
 						DVLOG(2) << "Lower Interval: " << lower_sum_intervalbound;
-						Polynom lower_sum_pol = sumFromZMinusGammaToUpper(intervalledPolynom.at(lower_sum_intervalbound), dimensional_upper_bound, lower_sum_intervalbound, SumFromZeroToUpper, Binomial::b);
-						return lower_sum_pol;
-					}());
-					DVLOG(2) << "Lower Sum: " << lower_sum;
+						sumFromZMinusGammaToUpper(lower_sum, intervalledPolynom.piece(witness_left_index-1), dimensional_upper_bound, lower_sum_intervalbound, PrecomputedSum { intervalledPolynom.summed(witness_left_index-1) }, Binomial::b);
+						DVLOG(2) << "Lower Sum: " << lower_sum;
+					}
 					
 					/**
 					 * Let:
@@ -175,22 +224,14 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 					 */
 					const Z const_sum = ( (witness_left_index > 0 || witness_right_index > 0) && witness_right_index-witness_left_index > 1) ? [&] () -> Z
 					{
-						Q const_sumq;
+						STATS_TIMER(const_sum);
+						Z const_sumz;
 						for(size_t constinterval = witness_left_index; constinterval <= witness_right_index-2; ++constinterval)
 						{
 							if(constinterval >= intervalbounds.size()) break; //!
-							const IB& intervalupper_bound = intervalbounds[constinterval]; //!
-							const Polynom& summedUp = SumFromZeroToUpper(intervalledPolynom.at(intervalupper_bound));
-							const_sumq += summedUp(intervalupper_bound);
-							if(constinterval > 0) //!< if we examine \f$I^n_j\f$ for a j > 0, then we have summed up to much -> subtract interval [0, s_j[
-							{
-								const IB& intervallower_bound = intervalbounds[constinterval-1]; //!
-								const_sumq -= summedUp(intervallower_bound);
-							}
+							const_sumz += intervalledPolynom.total(constinterval); // the pieces are published out of order, so there are no prefix sums
 						}
-						mpq_canonicalize(const_sumq.get_mpq_t());
-						DCHECK_EQ(const_sumq.get_den(), 1);
-						return const_sumq.get_num();
+						return const_sumz;
 					}() : 0;
 					DVLOG(2) << "Constant Sum: " << const_sum;
 					DCHECK_GE(const_sum, 0) << "Constant Sum is Negative!"; // Invariant: polynomial is non-negative
@@ -203,7 +244,7 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 					 * \f$ \sum_{k= s}^{z} p(k) \f$
 					 * where p is intervallPolynom.at(Right-Witness)
 					 */
-					const Polynom upper_sum( [&] () -> Polynom
+					Polynom upper_sum( [&] () -> Polynom
 					{
 						if(witness_right_index-1 >= intervalbounds.size()) {
 							Polynom upper_sum_pol(Polynom::zero);
@@ -211,7 +252,7 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 						}
 						const IB& upper_sum_intervalupper_bound = intervalbounds[witness_right_index-1]; //!
 						DVLOG(2) << "Upper Interval: " << upper_sum_intervalupper_bound;
-						Polynom upper_sum_pol = Polynom(SumFromZeroToUpper(intervalledPolynom.at(upper_sum_intervalupper_bound)));
+						Polynom upper_sum_pol = Polynom(intervalledPolynom.summed(witness_right_index-1));
 						DVLOG(2) << "upper_sum_pol pre " << upper_sum_pol;
 						if(witness_right_index > 1)
 						{
@@ -225,7 +266,8 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 					DVLOG(2) << "Upper Sum: " << upper_sum;
 
 					
-					Polynom* together = new Polynom(upper_sum + lower_sum);
+					Polynom* together = new Polynom(std::move(upper_sum));
+					if(has_lower_sum) (*together) += lower_sum;
 					(*together)[0] += const_sum;
 					DVLOG(2) << "Together Sum: " << (*together);
 					return together;
@@ -236,11 +278,12 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 
 		struct Job {
 			const size_t m_dimension;
+			const size_t m_index; //!< the index of the computed interval in the level m_dimension+1
 			const size_t m_witness_left_index;
 			const size_t m_witness_right_index;
 			std::promise<Polynom*> m_result;
-			Job(const size_t dimension, const size_t witness_left_index, const size_t witness_right_index, std::promise<Polynom*>&& result) 
-				: m_dimension(dimension), m_witness_left_index(witness_left_index), m_witness_right_index(witness_right_index), m_result(std::move(result))
+			Job(const size_t dimension, const size_t index, const size_t witness_left_index, const size_t witness_right_index, std::promise<Polynom*>&& result) 
+				: m_dimension(dimension), m_index(index), m_witness_left_index(witness_left_index), m_witness_right_index(witness_right_index), m_result(std::move(result))
 			{
 			}
 		};
@@ -256,20 +299,15 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 			const size_t numthreads
 			)
 	{
-		DVLOG(2) << "Interval Partitioning started";
-#ifndef NDEBUG
-		for(size_t i = 0; i < dimensions; ++i) {
-			DCHECK_GT(dimensional_upper_bounds[i], 0) << "Every dimensional upper bound has to be > 0";
-		}
-#endif
-		// maxdim is only used if useSymmetry to decide the cut-off
-		const size_t maxdim = std::accumulate(dimensional_upper_bounds, dimensional_upper_bounds+dimensions,static_cast<size_t>(0)); 
-		vektor<IB> intervalbounds;
-		SumFromZeroCacherThreadSafe sumcacher(dimensions); // instead of calling sumFromZeroToUpper each time, we cache its sum.
-		std::function<const Polynom&(const Polynom&)> SumFromZeroToUpper = [&sumcacher] (const Polynom& a) -> const Polynom& { return sumcacher(a);};
-
-		intervalbounds.push_back(dimensional_upper_bounds[0]);
+		return generateParallelIntervalPartition(SweepPlan(dimensional_upper_bounds, dimensions, useSymmetry), numthreads);
+	}
 
+	IntervalledPolynom generateParallelIntervalPartition(const SweepPlan& plan, const size_t numthreads, vektor<vektor<double>>* jobSeconds)
+	{
+		STATS_TIMER(sweep);
+		DVLOG(2) << "Interval Partitioning started";
+		const size_t dimensions = plan.dimensions();
+		const unsigned int* const dimensional_upper_bounds = plan.dimensional_upper_bounds();
 		std::queue<Job> jobs;
 
 		vektor<PiecedPolyAsync> piecewisePolynoms(dimensions);
@@ -278,134 +316,51 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 			Polynom* pol = new Polynom(1);
 			(*pol)[0] = 1;
 			piecewisePolynoms[0].push_back(dimensional_upper_bounds[0], pol);
+			if(dimensions > 1) {
+				piecewisePolynoms[0].sums.push_back(sumFromZeroToUpper(*pol));
+				piecewisePolynoms[0].totals.push_back(intervalTotal(piecewisePolynoms[0].sums[0], piecewisePolynoms[0].bounds(), 0));
+			}
 		}//!< This is exactly the induction base of Theorem 4.7
+		STATS_LEVEL(0, 1);
 
 		for(size_t k = 1; k < dimensions; ++k)
 		{
-			DVLOG(2) << "k: " << k;
-
-			vektor<IB> tmp_intervalbounds; //! in this array the interval bounds of the next round (k+1) will be stored
-//			PiecedPolyAsync tmp_intervalledPolynom; //! this will be the polynom of the next round (k+1)
-			vektor<IB> help_intervalbounds;
-			const unsigned int& dimensional_upper_bound = dimensional_upper_bounds[k];
-
-			//if(dimensional_upper_bound > 1) 
-			{ // we do now want a help_intervalbounds-value of 0
-				help_intervalbounds.push_back(dimensional_upper_bound - 1);
-			}
-
-
-			for(const IB& old_intervalbound : intervalbounds)
-				help_intervalbounds.push_back(old_intervalbound + dimensional_upper_bound);
-
-
-			
-			/**
-			 * i : intervalbounds[] index
-			 * j : help_intervalbounds[] index
-			 * witness_right_index, witness_left_index : intervalbounds[] index
-			 * witness_right, witness_left : help_intervalbounds[] value
-			 *
-			 */
-			for(size_t i = 0, j = 0, witness_left_index = 0, witness_right_index = 0; j < help_intervalbounds.size();)
+			const SweepPlan::Level& level = plan.level(k);
+			STATS_LEVEL(k, level.bounds.size());
+			piecewisePolynoms[k].level = k;
+			for(size_t i = 0; i < level.bounds.size(); ++i)
 			{
-
-				const IB& intervalbound = i < intervalbounds.size() ?  intervalbounds[i] : Z_zero;
-				const IB& help_intervalbound = help_intervalbounds[j];
-				
-				const IB& witness_right = get_witness(witness_right_index, intervalbounds);
-				const IB& witness_left = get_witness(witness_left_index, intervalbounds);
-				if(useSymmetry && witness_left >= maxdim/2) break;
-				DCHECK_LE(witness_left_index, intervalbounds.size()+1);
-				DCHECK_LE(witness_right_index, intervalbounds.size()+1);
-
-				DVLOG(2) << "k: " << k << ", i: " << i << ", j: " << j;
-				if(i < intervalbounds.size()) {
-					/**
-					 * We are examining intervalbounds[i] and help_intervalbounds[j] and pop
-					 * that value which is smaller (popping: increment either i or j)
-					 * If both values are the same, we increment both i and j.
-					 * min(intervalbounds[i], help_intervalbounds[j]) is appended to tmp_intervalbounds
-					 */
-					if(intervalbound < help_intervalbound) {
-						tmp_intervalbounds.push_back(intervalbound);
-						if(witness_right < intervalbound) {
-							++witness_right_index;
-						}
-						if(intervalbound > witness_left + dimensional_upper_bound ) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 1, addiere " << intervalbound;
-						++i;
-					}
-					else if(intervalbound > help_intervalbound)
-					{
-						tmp_intervalbounds.push_back(help_intervalbound);
-						if(witness_right < help_intervalbound) {
-							++witness_right_index;
-						}
-						if(help_intervalbound > witness_left + dimensional_upper_bound) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 2, addiere " << help_intervalbound;
-						++j;
-					}
-					else
-					{
-						tmp_intervalbounds.push_back(intervalbound);
-						if(intervalbound > witness_right) {
-							++witness_right_index;
-						}
-						if(intervalbound > witness_left + dimensional_upper_bound) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 3, addiere " << intervalbound;
-						++i;
-						++j;
-					}
-				} else {
-					/** We have already taken every element of intervalbounds[]. Because help_intervalbounds[] has some larger values, these have to 
-					 *  be examined:
-					 */
-					tmp_intervalbounds.push_back(help_intervalbound);
-					if(help_intervalbound > witness_right && witness_right_index <= intervalbounds.size()) {
-						++witness_right_index;
-					}
-					if(help_intervalbound > witness_left + dimensional_upper_bound) {
-						++witness_left_index;
-					}
-					DVLOG(2) << "Fall 4, addiere " << help_intervalbound;
-					++j;
-				}
-//				DVLOG(2) << "intervalledPolynom: " << piecewisePolynoms[k-1];
-//				DVLOG(2) << "tmp_intervalledPolynom: " << piecewisePolynoms[k];
-				DVLOG(2) << "Witness: " << "[" << witness_left_index << ", " << witness_right_index << "]";
-				DVLOG(2) << "tmp_intervalbounds: " << tmp_intervalbounds;
-				DVLOG(2) << "intervalbounds: " << intervalbounds;
-
 				std::promise<Polynom*> prom;
-
-				piecewisePolynoms[k].push_back(tmp_intervalbounds.back(), prom.get_future() );
-				jobs.emplace(k-1, witness_left_index, witness_right_index, std::move(prom));
-//				DCHECK_GE(tmp_intervalledPolynom.at(tmp_intervalbounds.back())(tmp_intervalbounds.back()), 0); // Invariant: polynomial is non-negative
+				piecewisePolynoms[k].push_back(level.bounds[i], prom.get_future() );
+				jobs.emplace(k-1, i, level.witnesses[i].left, level.witnesses[i].right, std::move(prom));
 			}
-
-/*#ifndef NDEBUG
-			DCHECK(has_ordering(tmp_intervalbounds, std::greater<IB>())); // Invariant: the numbers of tmp_intervalbounds are strict ascendending
-			for(const auto& ibound : tmp_intervalbounds) { //Invariant: the piecewise-defined polynomial is non-negative.
-				DCHECK_GE(piecewisePolynoms[k].at(ibound)(ibound), 0);
+			if(k+1 < dimensions) { // the sums of the last level are not needed
+				piecewisePolynoms[k].sums.resize(level.bounds.size());
+				piecewisePolynoms[k].totals.resize(level.bounds.size());
 			}
-#endif*/
-			intervalbounds.swap(tmp_intervalbounds);
-			//intervalledPolynom.swap(tmp_intervalledPolynom);
+		}
 
-			DVLOG(2) << "_old_intervals: " << intervalbounds;
+		/**
+		 * readers[m] is the number of unfinished jobs of level m+1, i.e., the jobs reading piecewisePolynoms[m].
+		 * The last of these jobs frees level m and the Faulhaber sums of its pieces, such that at most the levels
+		 * of the jobs currently running are kept in memory.
+		 */
+		std::unique_ptr<std::atomic<size_t>[]> readers(new std::atomic<size_t>[dimensions]);
+		for(size_t k = 0; k+1 < dimensions; ++k) readers[k] = piecewisePolynoms[k+1].bounds().size();
+
+		if(jobSeconds != nullptr) { // every entry is written by the thread running its job
+			jobSeconds->assign(dimensions, vektor<double>());
+			for(size_t k = 1; k < dimensions; ++k) (*jobSeconds)[k].resize(plan.level(k).bounds.size());
 		}
 
 		std::mutex queueMutex;
 		auto safePop = [&] () { 
-			std::lock_guard<std::mutex> guard(queueMutex);
-			if(jobs.empty()) return Job(0,0,0, std::promise<Polynom*>());
+			std::unique_lock<std::mutex> guard(queueMutex, std::try_to_lock);
+			if(!guard.owns_lock()) {
+				TRACE_SCOPE(Trace::wait_queue);
+				guard.lock();
+			}
+			if(jobs.empty()) return Job(0,0,0,0, std::promise<Polynom*>());
 			Job j(std::move(jobs.front())); 
 			jobs.pop();
 			return j;
@@ -414,14 +369,29 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 			while(!jobs.empty()) { 
 				Job j =std::move(safePop());
 				if(j.m_witness_left_index == 0 && j.m_witness_right_index == 0 && j.m_dimension == 0) return;
-				Polynom* p = sumParallelPolynomialOverWitnesses
-					( dimensional_upper_bounds[j.m_dimension+1] // == dimensional_upper_bound
-					  , piecewisePolynoms[j.m_dimension].bounds()
-					  , SumFromZeroToUpper
-					  , std::ref(piecewisePolynoms[j.m_dimension])
-					  , j.m_witness_left_index
-					  , j.m_witness_right_index);
-				j.m_result.set_value(p);
+				const size_t level = j.m_dimension;
+				{
+					TRACE_SCOPE(Trace::job, level+1, j.m_index, j.m_witness_left_index, j.m_witness_right_index);
+					const auto timeA = std::chrono::steady_clock::now();
+					Polynom* p = sumParallelPolynomialOverWitnesses
+						( dimensional_upper_bounds[j.m_dimension+1] // == dimensional_upper_bound
+						  , plan.level(j.m_dimension).bounds
+						  , std::ref(piecewisePolynoms[j.m_dimension])
+						  , j.m_witness_left_index
+						  , j.m_witness_right_index);
+					PiecedPolyAsync& produced = piecewisePolynoms[level+1];
+					if(!produced.sums.empty()) { // the jobs of the next level read the sum of p, such that it is computed once here
+						TRACE_SCOPE(Trace::faulhaber, level+1, j.m_index);
+						produced.sums[j.m_index] = sumFromZeroToUpper(*p);
+						produced.totals[j.m_index] = intervalTotal(produced.sums[j.m_index], produced.bounds(), j.m_index);
+					}
+					j.m_result.set_value(p);
+					if(jobSeconds != nullptr) (*jobSeconds)[level+1][j.m_index] = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeA).count();
+				}
+				STATS_ADD(jobs, 1);
+				if(--readers[level] == 0) {
+					piecewisePolynoms[level].release();
+				}
 			}};
 		std::thread* threads = new std::thread[numthreads];
 		for(size_t i = 0; i < numthreads; ++i)
@@ -447,7 +417,9 @@ void PiecedPolyAsync::swap(PiecedPolyAsync& o) {
 			}
 		}
 #endif
-		return intervalledPolynom.extract();
+		IntervalledPolynom result = intervalledPolynom.extract();
+		result.freeze();
+		return result;
 	}
 
 
@@ -31,21 +31,42 @@ namespace IntervalPartition
 		os << "}";
 		return os;
 	}
-	Polynom operator-(const Polynom& a, const Polynom& b) {
-		Polynom together(std::max(a.size(), b.size()));
-		for(size_t l = 0; l < together.size(); ++l) {
-			if(l < a.size()) together[l] += a[l];
-			if(l < b.size()) together[l] -= b[l];
+	Polynom& Polynom::operator+=(const Polynom& b) {
+		if(size() < b.size()) resize(b.size());
+		for(size_t l = 0; l < b.size(); ++l) mpq_add((*this)[l].get_mpq_t(), (*this)[l].get_mpq_t(), b[l].get_mpq_t());
+		return *this;
+	}
+	Polynom& Polynom::operator-=(const Polynom& b) {
+		if(size() < b.size()) resize(b.size());
+		for(size_t l = 0; l < b.size(); ++l) mpq_sub((*this)[l].get_mpq_t(), (*this)[l].get_mpq_t(), b[l].get_mpq_t());
+		return *this;
+	}
+	Polynom& Polynom::addmul(const Polynom& b, const Q& factor) {
+		thread_local Q product; // reused such that its limbs are allocated only once per thread
+		if(size() < b.size()) resize(b.size());
+		for(size_t l = 0; l < b.size(); ++l) {
+			mpq_mul(product.get_mpq_t(), b[l].get_mpq_t(), factor.get_mpq_t());
+			mpq_add((*this)[l].get_mpq_t(), (*this)[l].get_mpq_t(), product.get_mpq_t());
 		}
+		return *this;
+	}
+	Polynom operator-(const Polynom& a, const Polynom& b) {
+		Polynom together(a);
+		together -= b;
 		return together;
 	}
 	Polynom operator+(const Polynom& a, const Polynom& b) {
-		Polynom together(std::max(a.size(), b.size()));
-		for(size_t l = 0; l < together.size(); ++l) {
-			if(l < a.size()) together[l] += a[l];
-			if(l < b.size()) together[l] += b[l];
-		}
+		Polynom together(a);
+		together += b;
 		return together;
 	}
+	Polynom operator-(Polynom&& a, const Polynom& b) {
+		a -= b;
+		return std::move(a);
+	}
+	Polynom operator+(Polynom&& a, const Polynom& b) {
+		a += b;
+		return std::move(a);
+	}
 }
 
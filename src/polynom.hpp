@@ -25,6 +25,7 @@
 #ifndef POLYNOM_HPP
 #define POLYNOM_HPP
 #include "definitions.hpp"
+#include "stats.hpp"
 
 namespace IntervalPartition
 {
@@ -44,8 +45,10 @@ namespace IntervalPartition
 		Polynom(size_t psize) : vektor<Q>(psize) { }
 		Polynom(size_t psize, const size_t fill) : vektor<Q>(psize) { Q f = fill; for(auto& i : *this) i = f;  }
 		explicit Polynom(const Polynom& pol) : vektor<Q>(pol) {}
-		Polynom(Polynom&& pol) : vektor<Q>(pol) {}
+		Polynom(Polynom&& pol) : vektor<Q>(std::move(pol)) {}
 		Polynom() : vektor<Q>() {}
+		Polynom& operator=(const Polynom& pol) = default;
+		Polynom& operator=(Polynom&& pol) = default;
 
 		/**
 		 * Evaluates the polynom at position x
@@ -57,11 +60,32 @@ namespace IntervalPartition
 		Q operator()(const Q& x) const
 		{
 			Q res = at(size()-1);
-			for(size_t i = 1; i < size(); ++i)
-				res = res*x + at(size()-i-1);
-			mpq_canonicalize(res.get_mpq_t());
+			for(size_t i = 1; i < size(); ++i) {
+				res *= x;
+				res += at(size()-i-1);
+			}
+			{
+				STATS_TIMER(canonicalize);
+				mpq_canonicalize(res.get_mpq_t());
+			}
 			return res;
 		}
+
+		/**
+		 * In-place arithmetic. The polynom is enlarged if the other operand has more coefficients,
+		 * otherwise no memory is allocated besides the growth of the coefficients themselves.
+		 */
+		Polynom& operator+=(const Polynom& b);
+		Polynom& operator-=(const Polynom& b);
+		/**
+		 * Fused multiply-add: adds factor * b to this polynom
+		 */
+		Polynom& addmul(const Polynom& b, const Q& factor);
+		/**
+		 * Negates every coefficient
+		 */
+		void negate() { for(Q& coeff : *this) mpq_neg(coeff.get_mpq_t(), coeff.get_mpq_t()); }
+
 		/**
 		 * Canonicalizes the coefficients of the polynom.
 		 * These could be unnecessarily great, because gnump does not 
@@ -69,6 +93,7 @@ namespace IntervalPartition
 		 */
 		void canonicalize()
 		{
+			STATS_TIMER(canonicalize);
 			while(back() == 0) pop_back();
 			for(Q& coeff : *this) mpq_canonicalize(coeff.get_mpq_t());
 		}
@@ -79,6 +104,8 @@ namespace IntervalPartition
 
 	Polynom operator-(const Polynom& a, const Polynom& b);
 	Polynom operator+(const Polynom& a, const Polynom& b);
+	Polynom operator-(Polynom&& a, const Polynom& b); //!< reuses the storage of a
+	Polynom operator+(Polynom&& a, const Polynom& b); //!< reuses the storage of a
 }//ns
 #endif//guard
 
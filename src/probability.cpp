@@ -0,0 +1,106 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "probability.hpp"
+#include "interval_partition.hpp"
+#include <glog/logging.h>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace IntervalPartition {
+
+namespace {
+
+	/**
+	 * Splits a positive x into \f$ m 2^e \f$, where m is the integer of the leading 64 bits of x
+	 * @return m, which is exact in the 64-bit mantissa of a long double
+	 */
+	long double leadingBits(const Z& x, long& exponent) {
+		DCHECK_GT(x, 0);
+		const size_t bits = mpz_sizeinbase(x.get_mpz_t(), 2);
+		exponent = bits > 64 ? bits-64 : 0;
+		if(exponent == 0) return static_cast<long double>(mpz_get_ui(x.get_mpz_t()));
+		Z top;
+		mpz_tdiv_q_2exp(top.get_mpz_t(), x.get_mpz_t(), exponent);
+		return static_cast<long double>(mpz_get_ui(top.get_mpz_t()));
+	}
+
+}//ns
+
+PartitionProbability::PartitionProbability(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const size_t threads)
+	: m_boundSum(0), m_ones(0), m_total(1)
+{
+	static_assert(sizeof(unsigned long) >= sizeof(uint64_t), "mpz_get_ui has to return 64 bits");
+	vektor<unsigned int> bounds; // the bounds larger than one, as in number_of_interval_partitions
+	for(size_t i = 0; i < dimensions; ++i) {
+		m_total *= dimensional_upper_bounds[i] + 1UL;
+		if(dimensional_upper_bounds[i] == 1) ++m_ones;
+		else if(dimensional_upper_bounds[i] > 1) bounds.push_back(dimensional_upper_bounds[i]);
+	}
+	m_totalMantissa = leadingBits(m_total, m_totalExponent);
+	if(bounds.empty()) return;
+	m_boundSum = std::accumulate(bounds.begin(), bounds.end(), static_cast<size_t>(0));
+	m_polynom = threads == 1
+		? generateIntervalPartition(bounds.data(), bounds.size(), true)
+		: generateParallelIntervalPartition(bounds.data(), bounds.size(), true, threads);
+}
+
+Z PartitionProbability::count(const unsigned long z) const {
+	if(m_boundSum == 0) {
+		Z ret;
+		mpz_bin_uiui(ret.get_mpz_t(), m_ones, z);
+		return ret;
+	}
+	return evaluate_interval_partitions(m_polynom, m_boundSum, m_ones, z);
+}
+
+template<>
+long double PartitionProbability::probability<long double>(const unsigned long z) const {
+	const Z counted = count(z);
+	if(counted == 0) return 0;
+	long exponent;
+	const long double mantissa = leadingBits(counted, exponent);
+	return std::ldexp(mantissa / m_totalMantissa, static_cast<int>(exponent - m_totalExponent));
+}
+
+template<>
+double PartitionProbability::probability<double>(const unsigned long z) const {
+	return static_cast<double>(probability<long double>(z));
+}
+
+template<>
+mpf_class PartitionProbability::probability<mpf_class>(const unsigned long z) const {
+	return probability(z, mpf_get_default_prec());
+}
+
+mpf_class PartitionProbability::probability(const unsigned long z, const mp_bitcnt_t precision) const {
+	mpf_class ret(count(z), precision);
+	mpf_class denominator(m_total, precision);
+	mpf_div(ret.get_mpf_t(), ret.get_mpf_t(), denominator.get_mpf_t());
+	return ret;
+}
+
+double PartitionProbability::log_probability(const unsigned long z) const {
+	const Z counted = count(z);
+	if(counted == 0) return -std::numeric_limits<double>::infinity();
+	long exponent;
+	const long double mantissa = leadingBits(counted, exponent);
+	return static_cast<double>(std::log(mantissa / m_totalMantissa) + (exponent - m_totalExponent) * std::log(2.0L));
+}
+
+}//ns
@@ -0,0 +1,95 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file probability.hpp
+ * @brief The probability that a uniformly drawn vector below the upper bounds sums up to z
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef PROBABILITY_HPP
+#define PROBABILITY_HPP
+#include "intervalled_polynom.hpp"
+
+namespace IntervalPartition {
+
+	/**
+	 * Evaluates \f$ count(z) / \prod_i (i_i + 1) \f$, where count(z) is the number of partitions of z with upper bounds \f$ i_0, ..., i_{n-1} \f$,
+	 * and \f$ \prod_i (i_i + 1) \f$ is the number of all vectors below the bounds.
+	 * The piecewise-defined polynomial is built once, such that every query costs an exact evaluation of count(z).
+	 * The count and the denominator are converted to floating point by their leading bits and a binary exponent,
+	 * such that no decimal representation is produced, and a probability far below the smallest double is still available by log_probability.
+	 */
+	class PartitionProbability
+	{
+		public:
+			/**
+			 * @param dimensional_upper_bounds The upper bounds. A dimension with bound 0 only admits x_i = 0.
+			 * @param dimensions The length of dimensional_upper_bounds
+			 * @param threads number of threads used for building the polynomial
+			 */
+			PartitionProbability(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, const size_t threads = 1);
+
+			/**
+			 * @return the number of partitions of z
+			 */
+			Z count(const unsigned long z) const;
+			/**
+			 * @return the number of all vectors below the bounds
+			 */
+			const Z& total() const { return m_total; }
+
+			/**
+			 * @tparam t_Float double, long double or mpf_class with the default precision
+			 * @return the probability of z, with a relative error of at most \f$ 2^{-52} \f$ for double
+			 *  and \f$ 2^{-62} \f$ for long double, if the result is a normal number
+			 */
+			template<class t_Float>
+			t_Float probability(const unsigned long z) const;
+			/**
+			 * @return the probability of z computed with precision bits
+			 */
+			mpf_class probability(const unsigned long z, const mp_bitcnt_t precision) const;
+			/**
+			 * @return the natural logarithm of the probability of z, which is -infinity if z has no partition
+			 */
+			double log_probability(const unsigned long z) const;
+
+			/**
+			 * Computes probability<t_Float>(zs[i]) for every i, and writes it to probabilities[i].
+			 */
+			template<class t_Float>
+			void probabilities(const unsigned long* const zs, const size_t size, t_Float* const probabilities) const {
+				for(size_t i = 0; i < size; ++i) probabilities[i] = probability<t_Float>(zs[i]);
+			}
+
+		private:
+			IntervalledPolynom m_polynom; //!< built with useSymmetry from the bounds larger than one
+			size_t m_boundSum; //!< the sum of the bounds larger than one
+			size_t m_ones; //!< the number of bounds equal to one
+			Z m_total;
+			long double m_totalMantissa; //!< m_total = m_totalMantissa * 2^m_totalExponent
+			long m_totalExponent;
+	};
+
+	template<> double PartitionProbability::probability<double>(const unsigned long z) const;
+	template<> long double PartitionProbability::probability<long double>(const unsigned long z) const;
+	template<> mpf_class PartitionProbability::probability<mpf_class>(const unsigned long z) const;
+
+}//ns
+#endif//guard
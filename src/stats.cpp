@@ -0,0 +1,91 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "stats.hpp"
+#include <mutex>
+#include <set>
+
+namespace IntervalPartition
+{
+	constexpr bool Stats::enabled;
+	const char* const Stats::phaseNames[Stats::phases] = { "sweep", "sum_from_zero", "gamma_shift", "const_sum", "canonicalize", "evaluate" };
+
+	namespace {
+		/**
+		 * Knows the counters of all running threads, and keeps the sum of the counters of the finished ones
+		 */
+		struct Registry {
+			std::mutex mutex;
+			std::set<Stats*> running;
+			Stats finished;
+		};
+		Registry& registry() {
+			static Registry instance;
+			return instance;
+		}
+
+		struct ThreadStats {
+			Stats stats;
+			ThreadStats() {
+				std::lock_guard<std::mutex> guard(registry().mutex);
+				registry().running.insert(&stats);
+			}
+			~ThreadStats() {
+				std::lock_guard<std::mutex> guard(registry().mutex);
+				registry().finished += stats;
+				registry().running.erase(&stats);
+			}
+		};
+	}
+
+	Stats& Stats::local() {
+		thread_local ThreadStats threadStats;
+		return threadStats.stats;
+	}
+
+	Stats& Stats::operator+=(const Stats& o) {
+		for(size_t k = 0; k < o.intervals.size(); ++k) addLevel(k, o.intervals[k]);
+		jobs += o.jobs;
+		sums += o.sums;
+		cacheHits += o.cacheHits;
+		cacheMisses += o.cacheMisses;
+		for(size_t p = 0; p < phases; ++p) nanos[p] += o.nanos[p];
+		return *this;
+	}
+
+	Stats Stats::collect() {
+		std::lock_guard<std::mutex> guard(registry().mutex);
+		Stats sum = registry().finished;
+		for(const Stats* stats : registry().running) sum += *stats;
+		return sum;
+	}
+
+	void Stats::reset() {
+		std::lock_guard<std::mutex> guard(registry().mutex);
+		registry().finished = Stats();
+		for(Stats* stats : registry().running) *stats = Stats();
+	}
+
+	void Stats::json(std::ostream& os) const {
+		os << "{\"enabled\": " << (enabled ? "true" : "false") << ", \"intervals\": [";
+		for(size_t k = 0; k < intervals.size(); ++k) os << (k > 0 ? ", " : "") << intervals[k];
+		os << "], \"jobs\": " << jobs << ", \"sums\": " << sums << ", \"cache_hits\": " << cacheHits << ", \"cache_misses\": " << cacheMisses << ", \"seconds\": {";
+		for(size_t p = 0; p < phases; ++p) os << (p > 0 ? ", " : "") << "\"" << phaseNames[p] << "\": " << nanos[p]*1e-9;
+		os << "}}";
+	}
+
+}//namespace
@@ -0,0 +1,118 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file stats.hpp
+ * @brief Performance counters and phase timers, compiled in only with WITH_STATS
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * Every thread counts into its own Stats object. Stats::collect sums up the objects of all threads.
+ * Without WITH_STATS, the macros STATS_TIMER, STATS_ADD and STATS_LEVEL expand to nothing.
+ */
+#ifndef STATS_HPP
+#define STATS_HPP
+#include "definitions.hpp"
+#include "macros.hpp"
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace IntervalPartition {
+
+	struct Stats {
+		/**
+		 * The timed phases. A phase includes the phases called from it, e.g., sweep includes all others but evaluate.
+		 * The time of a phase is summed over all threads, such that the phases run by the workers of the parallel generator
+		 * can take longer than its sweep.
+		 */
+		enum Phase {
+			sweep, //!< generateIntervalPartition and generateParallelIntervalPartition
+			sum_from_zero, //!< sumFromZeroToUpper, i.e., computing the Faulhaber sums
+			gamma_shift, //!< sumFromZeroToZMinusGamma
+			const_sum, //!< the totals of the pieces over their intervals, which make up the constant sums of sumPolynomialOverWitnesses
+			canonicalize, //!< canonicalization of rationals, e.g., of the values of a polynomial that have to be integers
+			evaluate, //!< evaluate_interval_partitions
+			phases
+		};
+		static const char* const phaseNames[phases];
+
+		vektor<uint64_t> intervals; //!< intervals[k] is the number of intervals computed for level k
+		uint64_t jobs = 0; //!< the number of computed pieces, i.e., calls of sumPolynomialOverWitnesses
+		uint64_t sums = 0; //!< the number of computed Faulhaber sums, i.e., calls of sumFromZeroToUpper
+		uint64_t cacheHits = 0; //!< lookups of a Faulhaber sum that was already cached in a SumFromZeroCacher
+		uint64_t cacheMisses = 0;
+		uint64_t nanos[phases] = {}; //!< time spent in each phase
+
+#ifdef WITH_STATS
+		static constexpr bool enabled = true;
+#else
+		static constexpr bool enabled = false;
+#endif
+
+		void addLevel(const size_t level, const uint64_t count) {
+			if(intervals.size() <= level) intervals.resize(level+1, 0);
+			intervals[level] += count;
+		}
+		Stats& operator+=(const Stats& o);
+
+		/** Writes the counters as a JSON object */
+		void json(std::ostream& os) const;
+
+		/** @return the counters of the calling thread */
+		static Stats& local();
+
+		/**
+		 * @return the sum of the counters of all threads, including threads that have already finished
+		 * @pre no other thread is counting at the same time
+		 */
+		static Stats collect();
+
+		/**
+		 * Sets the counters of all threads to zero
+		 * @pre no other thread is counting at the same time
+		 */
+		static void reset();
+
+		/**
+		 * Adds the lifetime of the timer to a phase of the calling thread
+		 */
+		class Timer {
+			const Phase m_phase;
+			const std::chrono::steady_clock::time_point m_start;
+			public:
+			explicit Timer(const Phase phase) : m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+			~Timer() {
+				local().nanos[m_phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+			}
+		};
+	};
+
+}//ns
+
+#ifdef WITH_STATS
+#define STATS_TIMER(phase) const IntervalPartition::Stats::Timer MAKE_UNIQUE(statsTimer)(IntervalPartition::Stats::phase)
+#define STATS_ADD(counter, value) (IntervalPartition::Stats::local().counter += (value))
+#define STATS_LEVEL(level, count) IntervalPartition::Stats::local().addLevel(level, count)
+#else
+#define STATS_TIMER(phase)
+#define STATS_ADD(counter, value) ((void)0)
+#define STATS_LEVEL(level, count) ((void)0)
+#endif
+
+#endif//guard
@@ -10,6 +10,8 @@
 #define SUMFROMZEROCACHER_HPP
 
 #include "sum_from_zero_to_upper.hpp"
+#include "intervalled_polynom.hpp"
+#include "stats.hpp"
 
 namespace IntervalPartition {
 
@@ -31,8 +33,12 @@ namespace IntervalPartition {
         const Polynom& operator()(const Polynom& p) {
             {
                 std::map<Polynom, Polynom>::const_iterator it = cache.find(p);
-                if(it != cache.end()) return it->second;
+                if(it != cache.end()) {
+                    STATS_ADD(cacheHits, 1);
+                    return it->second;
+                }
             }
+            STATS_ADD(cacheMisses, 1);
             // Create a new polynomial
 #ifndef NDEBUG
             auto npair = std::move(cache.emplace(p, std::move(sumFromZeroToUpper(p)) ));
@@ -42,6 +48,94 @@ namespace IntervalPartition {
             return cache.emplace(p, std::move(sumFromZeroToUpper(p)) ).first->second;
 #endif
         }                                                                                                                                                      
+
+		/** @return the number of cached sums */
+		size_t size() const { return cache.size(); }
+
+		/**
+		 * Drops all cached sums
+		 * @pre no sweep is using this cacher, since it hands out references to the sums
+		 */
+		void clear() { cache.clear(); }
     };
+
+	/**
+	 * A sum function for sum_from_zero_to_upper.hpp that returns the Faulhaber sum of p computed beforehand
+	 */
+	struct PrecomputedSum {
+		const Polynom& summedUp;
+		const Polynom& operator()(const Polynom& p) const {
+			DCHECK_EQ(p.size()+1, summedUp.size());
+			(void) p; // only checked in debug builds
+			return summedUp;
+		}
+	};
+
+	/**
+	 * Computes the total of a piece over its interval, i.e., \f$ \sum_{k=s}^{t} p(k) \f$ for the index-th interval [s,t]
+	 * @param summedUp the Faulhaber sum of the piece p
+	 * @param intervalbounds the upper bounds of the intervals, such that s = intervalbounds[index-1]+1, or s = 0 if index = 0
+	 */
+	inline Z intervalTotal(const Polynom& summedUp, const vektor<IB>& intervalbounds, const size_t index) {
+		DCHECK_LT(index, intervalbounds.size());
+		Q total = summedUp(intervalbounds[index]);
+		if(index > 0) total -= summedUp(intervalbounds[index-1]); //!< we have summed up too much -> subtract the interval [0, s[
+		DCHECK_EQ(total.get_den(), 1);
+		return total.get_num();
+	}
+
+	/**
+	 * @brief The Faulhaber sums of all pieces of a piecewise-defined polynomial, addressed by the index of their interval.
+	 * The sweep fills it once per level, such that a sum is found without comparing polynomials.
+	 * It also keeps the prefix sums of the totals of the pieces over their intervals,
+	 * such that the sum over a range of intervals is a single subtraction.
+	 */
+	class SumFromZeroTable
+	{
+		vektor<Polynom> computed; //!< the sums computed by the table itself, if there is no cacher
+		vektor<const Polynom*> sums; //!< sums[i] is the sum of the i-th piece
+		vektor<Z> prefix; //!< prefix[i] is the sum of the totals of the pieces 0, ..., i-1 over their intervals
+
+		void computePrefix(const vektor<IB>& intervalbounds) {
+			STATS_TIMER(const_sum);
+			prefix.resize(sums.size()+1);
+			prefix[0] = 0;
+			for(size_t i = 0; i < sums.size(); ++i) prefix[i+1] = prefix[i] + intervalTotal(*sums[i], intervalbounds, i);
+		}
+
+		public:
+		/**
+		 * Computes the sums of all pieces of intervalledPolynom, replacing the previous ones
+		 * @param sumcacher if not null, the sums are looked up in this cache, which keeps them alive across multiple sweeps
+		 */
+		void assign(const IntervalledPolynom& intervalledPolynom, SumFromZeroCacher* sumcacher) {
+			const size_t pieces = intervalledPolynom.polynomials().size();
+			sums.resize(pieces);
+			if(sumcacher != nullptr) {
+				vektor<Polynom>().swap(computed);
+				for(size_t i = 0; i < pieces; ++i) sums[i] = &(*sumcacher)(intervalledPolynom.piece(i));
+			} else {
+				computed.resize(pieces); // no reallocation below, such that the pointers stay valid
+				for(size_t i = 0; i < pieces; ++i) {
+					computed[i] = sumFromZeroToUpper(intervalledPolynom.piece(i));
+					sums[i] = &computed[i];
+				}
+			}
+			computePrefix(intervalledPolynom.bounds());
+		}
+		size_t size() const { return sums.size(); }
+		/**
+		 * @return the sum of the totals of the pieces from, ..., to-1 over their intervals
+		 */
+		Z rangeTotal(const size_t from, const size_t to) const {
+			DCHECK_LE(from, to);
+			DCHECK_LT(to, prefix.size());
+			return prefix[to] - prefix[from];
+		}
+		const Polynom& operator[](const size_t interval) const {
+			DCHECK_LT(interval, sums.size());
+			return *sums[interval];
+		}
+	};
 }//ns
 #endif /* SUMFROMZEROCACHER_HPP */
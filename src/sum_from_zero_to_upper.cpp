@@ -18,6 +18,7 @@
 #include "sum_from_zero_to_upper.hpp"
 #include "faulhaber.hpp"
 #include "binomial.hpp"
+#include "stats.hpp"
 #include <glog/logging.h>
 
 namespace IntervalPartition
@@ -31,6 +32,9 @@ namespace IntervalPartition
  */
 Polynom sumFromZeroToUpper(const Polynom& p)
 {
+	STATS_TIMER(sum_from_zero);
+	STATS_ADD(sums, 1);
+	thread_local Q product;
 	Polynom ret(p.size()+1);
 	for(size_t l = 0; l < p.size()+1; ++l) // l : Index of faulhaber's polynom
 	{
@@ -39,7 +43,8 @@ Polynom sumFromZeroToUpper(const Polynom& p)
 		{
 			const Polynom& faulhaberpolynom = Faulhaber::f(j);
 			if(faulhaberpolynom.size() <= l) continue;
-			koeff += faulhaberpolynom.at(l) * p[j];
+			mpq_mul(product.get_mpq_t(), faulhaberpolynom.at(l).get_mpq_t(), p[j].get_mpq_t());
+			koeff += product;
 		}
 	}
 	ret[0] += p[0];
@@ -27,6 +27,7 @@
 #define SUM_FROM_ZERO_TO_UPPER
 #include <map>
 #include "polynom.hpp"
+#include "stats.hpp"
 
 namespace IntervalPartition
 {   
@@ -45,29 +46,45 @@ namespace IntervalPartition
  * and rewrite the coefficients
  * to match the \f$ z-\gamma \f$ upper bound of the sum.
  *
+ * @param ret receives the polynom. Its coefficients are overwritten, such that their memory is reused.
  * @tparam \function sumFromZeroToUpper or a function that caches these values
  * @tparam \class Binomial, Binomial::b or a function that returns binomial coefficients
  */
 template<class t_SumFunction, class t_Binomial>
-inline Polynom sumFromZeroToZMinusGamma(const Polynom& p, const Z& gamma, const t_SumFunction& sumFunction, const t_Binomial& binomial) {
-	Polynom ret(p.size()+1);
+inline void sumFromZeroToZMinusGamma(Polynom& ret, const Polynom& p, const Z& gamma, const t_SumFunction& sumFunction, const t_Binomial& binomial) {
+	STATS_TIMER(gamma_shift);
+	thread_local Z gammapot;
+	thread_local Z factor;
+	thread_local Q product;
+	ret.resize(p.size()+1);
 	const Polynom& summedUp = sumFunction(p);
 	for(size_t m = 0; m < p.size()+1; ++m) // m: index of leibniz binomial formula
 	{
 		Q& coeff = ret[m];
-		Z gammapot = 1;
+		mpq_set_ui(coeff.get_mpq_t(), 0, 1);
+		mpz_set_ui(gammapot.get_mpz_t(), 1);
 		for(size_t l = m; l < p.size()+1; ++l) {
-			coeff += summedUp[l] * binomial(l,m) * gammapot;
-			gammapot *= -gamma;
+			const Z& binomialCoefficient = binomial(l,m);
+			mpz_mul(factor.get_mpz_t(), binomialCoefficient.get_mpz_t(), gammapot.get_mpz_t());
+			mpq_set_z(product.get_mpq_t(), factor.get_mpz_t());
+			mpq_mul(product.get_mpq_t(), product.get_mpq_t(), summedUp[l].get_mpq_t());
+			mpq_add(coeff.get_mpq_t(), coeff.get_mpq_t(), product.get_mpq_t());
+			mpz_mul(gammapot.get_mpz_t(), gammapot.get_mpz_t(), gamma.get_mpz_t());
+			mpz_neg(gammapot.get_mpz_t(), gammapot.get_mpz_t());
 		}
 	}
+}
+template<class t_SumFunction, class t_Binomial>
+inline Polynom sumFromZeroToZMinusGamma(const Polynom& p, const Z& gamma, const t_SumFunction& sumFunction, const t_Binomial& binomial) {
+	Polynom ret;
+	sumFromZeroToZMinusGamma(ret, p, gamma, sumFunction, binomial);
 	return ret;
 }
 
 /** 
  * Computes \f$ \sum_{k = z - \gamma}^{upper} p(k) \f$
  * 
- * @return the polynom resulting by the summation
+ * @param ret receives the polynom resulting by the summation. Its coefficients are overwritten, such that their memory is reused.
  *
  * We use the function t_SumFunction to sum up the polynom 
  * and rewrite the coefficients.
@@ -78,12 +95,17 @@ inline Polynom sumFromZeroToZMinusGamma(const Polynom& p, const Z& gamma, const
  * @tparam \function sumFromZeroToUpper or a function that caches these values
  */
 template<class t_SumFunction, class t_Binomial>
+inline void sumFromZMinusGammaToUpper(Polynom& ret, const Polynom& p, const Z& gamma, const Z& upper, const t_SumFunction& sumFunction, const t_Binomial& binomial) {
+	thread_local Z gammaplus;
+	mpz_add_ui(gammaplus.get_mpz_t(), gamma.get_mpz_t(), 1);
+	sumFromZeroToZMinusGamma<t_SumFunction, t_Binomial>(ret, p, gammaplus, sumFunction, binomial);
+	ret.negate();
+	ret[0] += sumFunction(p)(upper);
+}
+template<class t_SumFunction, class t_Binomial>
 inline Polynom sumFromZMinusGammaToUpper(const Polynom& p, const Z& gamma, const Z& upper, const t_SumFunction& sumFunction, const t_Binomial& binomial) {
-	const Q highest = sumFunction(p)(upper);
-	Polynom diff = sumFromZeroToZMinusGamma<t_SumFunction, t_Binomial>(p,gamma+1, sumFunction, binomial);
-	for(Q& coeff : diff)
-		coeff = -coeff;
-	diff[0] += highest;
+	Polynom diff;
+	sumFromZMinusGammaToUpper(diff, p, gamma, upper, sumFunction, binomial);
 	return diff;
 }
 
@@ -0,0 +1,196 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl, Roland Glück
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sweep_plan.hpp"
+#include "util.hpp"
+#include <limits>
+#include <numeric>
+
+namespace IntervalPartition
+{
+
+	/** 
+	 * Returns the witness interval's upper bound
+	 * This function is used to prevent out-of-bounds (reading over intervalbound)
+	 * 
+	 * @param witness_index an index part of intervalbounds
+	 * @param intervalbounds a set of numbers that shall represent the upper bounds of a set of piecewise disjoint intervals covering Z
+	 * 
+	 * @return an entry of intervalbounds
+	 */
+	const IB& get_witness(size_t witness_index, const vektor<IB>& intervalbounds) {
+		if(witness_index == 0) return IB_zero;
+		if(witness_index > intervalbounds.size()) return intervalbounds[intervalbounds.size()-1];
+		return intervalbounds[witness_index-1];
+	}
+
+	SweepPlan::SweepPlan(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry)
+		: m_dimensional_upper_bounds(dimensions), m_useSymmetry(useSymmetry), m_levels(dimensions)
+	{
+		DVLOG(2) << "Sweep planning started";
+		DCHECK_GT(dimensions, 0);
+#ifndef NDEBUG
+		for(size_t i = 0; i < dimensions; ++i) {
+			DCHECK_GT(dimensional_upper_bounds[i], 0) << "Every dimensional upper bound has to be > 0";
+		}
+#endif
+		CHECK_LE(dimensions, std::numeric_limits<IB>::max() / std::numeric_limits<unsigned int>::max()) << "The sum of the bounds has to fit into an interval bound"; // not a DCHECK, as a wrapped interval bound would go unnoticed
+		std::copy(dimensional_upper_bounds, dimensional_upper_bounds+dimensions, m_dimensional_upper_bounds.begin());
+		// maxdim is only used if useSymmetry to decide the cut-off
+		const size_t maxdim = std::accumulate(dimensional_upper_bounds, dimensional_upper_bounds+dimensions,static_cast<size_t>(0)); 
+
+		m_levels[0].bounds.push_back(dimensional_upper_bounds[0]); //!< This is exactly the induction base of Theorem 4.7
+
+		for(size_t k = 1; k < dimensions; ++k)
+		{
+			DVLOG(2) << "k: " << k;
+
+			const vektor<IB>& intervalbounds = m_levels[k-1].bounds;
+			vektor<IB>& tmp_intervalbounds = m_levels[k].bounds; //! in this array the interval bounds of the next round (k+1) will be stored
+			vektor<Witness>& witnesses = m_levels[k].witnesses;
+			vektor<IB> help_intervalbounds;
+			const unsigned int& dimensional_upper_bound = dimensional_upper_bounds[k];
+
+			//if(dimensional_upper_bound > 1) 
+			{ // we do now want a help_intervalbounds-value of 0
+				help_intervalbounds.push_back(dimensional_upper_bound - 1);
+			}
+
+
+			for(const IB& old_intervalbound : intervalbounds)
+				help_intervalbounds.push_back(old_intervalbound + dimensional_upper_bound);
+
+
+			
+			/**
+			 * i : intervalbounds[] index
+			 * j : help_intervalbounds[] index
+			 * witness_right_index, witness_left_index : intervalbounds[] index
+			 * witness_right, witness_left : help_intervalbounds[] value
+			 *
+			 */
+			for(size_t i = 0, j = 0, witness_left_index = 0, witness_right_index = 0; j < help_intervalbounds.size();)
+			{
+
+				const IB& intervalbound = i < intervalbounds.size() ?  intervalbounds[i] : IB_zero;
+				const IB& help_intervalbound = help_intervalbounds[j];
+				
+				const IB& witness_right = get_witness(witness_right_index, intervalbounds);
+				const IB& witness_left = get_witness(witness_left_index, intervalbounds);
+				if(useSymmetry && witness_left >= maxdim/2) break;
+				DCHECK_LE(witness_left_index, intervalbounds.size()+1);
+				DCHECK_LE(witness_right_index, intervalbounds.size()+1);
+
+				DVLOG(2) << "k: " << k << ", i: " << i << ", j: " << j;
+				if(i < intervalbounds.size()) {
+					/**
+					 * We are examining intervalbounds[i] and help_intervalbounds[j] and pop
+					 * that value which is smaller (popping: increment either i or j)
+					 * If both values are the same, we increment both i and j.
+					 * min(intervalbounds[i], help_intervalbounds[j]) is appended to tmp_intervalbounds
+					 */
+					if(intervalbound < help_intervalbound) {
+						tmp_intervalbounds.push_back(intervalbound);
+						if(witness_right < intervalbound) {
+							++witness_right_index;
+						}
+						if(intervalbound > witness_left + dimensional_upper_bound ) {
+							++witness_left_index;
+						}
+						DVLOG(2) << "Fall 1, addiere " << intervalbound;
+						++i;
+					}
+					else if(intervalbound > help_intervalbound)
+					{
+						tmp_intervalbounds.push_back(help_intervalbound);
+						if(witness_right < help_intervalbound) {
+							++witness_right_index;
+						}
+						if(help_intervalbound > witness_left + dimensional_upper_bound) {
+							++witness_left_index;
+						}
+						DVLOG(2) << "Fall 2, addiere " << help_intervalbound;
+						++j;
+					}
+					else
+					{
+						tmp_intervalbounds.push_back(intervalbound);
+						if(intervalbound > witness_right) {
+							++witness_right_index;
+						}
+						if(intervalbound > witness_left + dimensional_upper_bound) {
+							++witness_left_index;
+						}
+						DVLOG(2) << "Fall 3, addiere " << intervalbound;
+						++i;
+						++j;
+					}
+				} else {
+					/** We have already taken every element of intervalbounds[]. Because help_intervalbounds[] has some larger values, these have to 
+					 *  be examined:
+					 */
+					tmp_intervalbounds.push_back(help_intervalbound);
+					if(help_intervalbound > witness_right && witness_right_index <= intervalbounds.size()) {
+						++witness_right_index;
+					}
+					if(help_intervalbound > witness_left + dimensional_upper_bound) {
+						++witness_left_index;
+					}
+					DVLOG(2) << "Fall 4, addiere " << help_intervalbound;
+					++j;
+				}
+				DVLOG(2) << "Witness: " << "[" << witness_left_index << ", " << witness_right_index << "]";
+				DVLOG(2) << "tmp_intervalbounds: " << tmp_intervalbounds;
+				DVLOG(2) << "intervalbounds: " << intervalbounds;
+				DCHECK_LE(witness_right_index, std::numeric_limits<uint32_t>::max());
+				witnesses.push_back(Witness { static_cast<uint32_t>(witness_left_index), static_cast<uint32_t>(witness_right_index) });
+			}
+			DCHECK(has_ordering(tmp_intervalbounds, std::greater<IB>())); // Invariant: the numbers of tmp_intervalbounds are strict ascendending
+			DVLOG(2) << "_old_intervals: " << tmp_intervalbounds;
+		}
+	}
+
+	double SweepPlan::criticalPath(const vektor<vektor<double>>& jobSeconds) const {
+		DCHECK_EQ(jobSeconds.size(), dimensions());
+		vektor<double> finished(1); //!< finished[i] is the length of the longest chain ending with the i-th job of the previous level
+		double longest = 0; // a chain can end at any level, since the next level does not need to read every piece
+		for(size_t k = 1; k < dimensions(); ++k) {
+			const Level& level = m_levels[k];
+			DCHECK_EQ(jobSeconds[k].size(), level.bounds.size());
+			vektor<double> current(level.bounds.size());
+			for(size_t i = 0; i < level.bounds.size(); ++i) {
+				// the job reads the pieces witness.left-1 up to witness.right-1 of the previous level, cf. sumPolynomialOverWitnesses
+				const Witness& witness = level.witnesses[i];
+				const size_t first = witness.left > 0 ? witness.left-1 : 0;
+				const size_t last = std::min<size_t>(witness.right > 0 ? witness.right-1 : 0, finished.size()-1);
+				double predecessor = 0;
+				for(size_t j = first; j <= last; ++j) predecessor = std::max(predecessor, finished[j]);
+				current[i] = predecessor + jobSeconds[k][i];
+				longest = std::max(longest, current[i]);
+			}
+			finished.swap(current);
+		}
+		return longest;
+	}
+
+	size_t SweepPlan::pieces() const {
+		size_t sum = 0;
+		for(const Level& level : m_levels) sum += level.bounds.size();
+		return sum;
+	}
+
+}//namespace
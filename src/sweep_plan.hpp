@@ -0,0 +1,92 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file sweep_plan.hpp
+ * @brief The interval bounds and witnesses of every level of the sweep, independent of any polynomial
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ */
+#ifndef SWEEP_PLAN_HPP
+#define SWEEP_PLAN_HPP
+#include "definitions.hpp"
+#include <cstdint>
+
+namespace IntervalPartition {
+
+	/**
+	 * Runs the merge sweep of Theorem 4.7 on the bounds only.
+	 * Level k lists the intervals of the piecewise-defined polynomial counting the partitions into the first k+1 dimensions.
+	 * For each interval, it stores the witnesses, i.e., the range of intervals of level k-1 that are summed up.
+	 * The plan fixes the whole dependency graph before any polynomial is computed,
+	 * such that it can be built once and executed by any generator.
+	 */
+	class SweepPlan
+	{
+		public:
+			/**
+			 * The intervals witness_left-1, ..., witness_right-1 of the previous level, cf. sumPolynomialOverWitnesses
+			 */
+			struct Witness {
+				uint32_t left;
+				uint32_t right;
+			};
+			/**
+			 * The i-th entry of a level is the interval ending at bounds[i] together with witnesses[i]
+			 */
+			struct Level {
+				vektor<IB> bounds;
+				vektor<Witness> witnesses; //!< empty for the first level
+			};
+
+			/**
+			 * @param dimensional_upper_bounds The upper bounds, every value has to be strictly larger than 0. The array is copied.
+			 * @param dimensions The length of dimensional_upper_bounds, has to be strictly larger than 0
+			 * @param useSymmetry Stops every level at the half of the sum of all bounds, cf. generateIntervalPartition
+			 */
+			SweepPlan(const unsigned int* const dimensional_upper_bounds, const size_t dimensions, bool useSymmetry);
+
+			size_t dimensions() const { return m_dimensional_upper_bounds.size(); }
+			const unsigned int* dimensional_upper_bounds() const { return m_dimensional_upper_bounds.data(); }
+			bool symmetric() const { return m_useSymmetry; }
+			const Level& level(const size_t k) const { return m_levels[k]; }
+
+			/**
+			 * @return the number of intervals over all levels, i.e., the number of polynomials an executor computes
+			 */
+			size_t pieces() const;
+
+			/**
+			 * Computes the longest chain of jobs in which each job reads a piece computed by its predecessor.
+			 * The job of an interval of level k reads the pieces of level k-1 between its witnesses.
+			 * @param jobSeconds jobSeconds[k][i] is the time of the job computing the i-th interval of level k, as measured by generateParallelIntervalPartition
+			 * @return the sum of the times of the jobs on this chain, i.e., the running time with arbitrarily many threads
+			 */
+			double criticalPath(const vektor<vektor<double>>& jobSeconds) const;
+
+		private:
+			vektor<unsigned int> m_dimensional_upper_bounds;
+			bool m_useSymmetry;
+			vektor<Level> m_levels;
+	};
+
+	/** Internal Usage **/
+	const IB& get_witness(size_t witness_index, const vektor<IB>& intervalbounds);
+
+}//ns
+#endif//guard
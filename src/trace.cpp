@@ -0,0 +1,161 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "trace.hpp"
+#include "definitions.hpp"
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+
+namespace IntervalPartition
+{
+	constexpr bool Trace::enabled;
+	constexpr size_t Trace::maxArgs;
+
+	namespace {
+		const char* const kindNames[Trace::kinds] = { "job", "wait_piece", "wait_queue", "faulhaber" };
+		const char* const argNames[Trace::kinds][Trace::maxArgs] = {
+			{ "level", "interval", "witness_left", "witness_right" },
+			{ "level", "interval", nullptr, nullptr },
+			{ nullptr, nullptr, nullptr, nullptr },
+			{ "level", "interval", nullptr, nullptr }
+		};
+
+		/** Writes nanoseconds as microseconds with three decimals, as the trace event format expects microseconds */
+		void writeMicros(std::ostream& os, const uint64_t nanos) {
+			const uint64_t fraction = nanos % 1000;
+			os << nanos/1000 << "." << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+		}
+
+		/**
+		 * The events of a thread. If more than capacity events are recorded, the oldest ones are overwritten.
+		 */
+		struct RingBuffer {
+			size_t thread; //!< the tid in the trace
+			vektor<Trace::Event> events;
+			size_t recorded = 0; //!< the number of events recorded since start, events[recorded % capacity] is overwritten next
+			bool finished = false; //!< its thread has exited
+
+			void clear(const size_t capacity) {
+				events.clear();
+				events.reserve(capacity);
+				recorded = 0;
+			}
+			void push(const Trace::Event& event) {
+				if(events.size() < events.capacity()) events.push_back(event);
+				else if(!events.empty()) events[recorded % events.size()] = event;
+				++recorded;
+			}
+		};
+
+		/**
+		 * Knows the buffers of all threads. The buffer of a finished thread is kept until the next start, such that the workers
+		 * of the parallel generator can be traced after they were joined.
+		 */
+		struct Registry {
+			std::mutex mutex;
+			std::list<RingBuffer> buffers;
+			size_t capacity = 1<<16;
+			size_t threads = 0;
+			std::atomic<bool> recording { false };
+			std::chrono::steady_clock::time_point start;
+		};
+		Registry& registry() {
+			static Registry instance;
+			return instance;
+		}
+
+		struct LocalBuffer {
+			RingBuffer* buffer = nullptr;
+			~LocalBuffer() {
+				if(buffer == nullptr) return;
+				std::lock_guard<std::mutex> guard(registry().mutex);
+				buffer->finished = true;
+			}
+		};
+
+		RingBuffer& localBuffer() {
+			thread_local LocalBuffer local;
+			if(local.buffer == nullptr) {
+				Registry& r = registry();
+				std::lock_guard<std::mutex> guard(r.mutex);
+				r.buffers.emplace_back();
+				local.buffer = &r.buffers.back();
+				local.buffer->thread = r.threads++;
+				local.buffer->clear(r.capacity);
+			}
+			return *local.buffer;
+		}
+	}
+
+	void Trace::start(const size_t capacity) {
+		Registry& r = registry();
+		std::lock_guard<std::mutex> guard(r.mutex);
+		r.capacity = capacity;
+		r.buffers.remove_if([] (const RingBuffer& buffer) { return buffer.finished; });
+		for(RingBuffer& buffer : r.buffers) buffer.clear(capacity);
+		r.start = std::chrono::steady_clock::now();
+		r.recording = true;
+	}
+
+	void Trace::stop() {
+		registry().recording = false;
+	}
+
+	bool Trace::recording() {
+		return registry().recording.load(std::memory_order_relaxed);
+	}
+
+	uint64_t Trace::now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().start).count();
+	}
+
+	void Trace::record(const Event& event) {
+		localBuffer().push(event);
+	}
+
+	void Trace::json(std::ostream& os) {
+		Registry& r = registry();
+		std::lock_guard<std::mutex> guard(r.mutex);
+		os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+		bool first = true;
+		for(const RingBuffer& buffer : r.buffers) {
+			if(buffer.recorded == 0) continue;
+			os << (first ? "" : ",") << "\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer.thread
+				<< ", \"args\": {\"name\": \"thread " << buffer.thread << "\"}}";
+			first = false;
+			const size_t oldest = buffer.recorded > buffer.events.size() ? buffer.recorded % buffer.events.size() : 0;
+			for(size_t i = 0; i < buffer.events.size(); ++i) {
+				const Event& event = buffer.events[(oldest + i) % buffer.events.size()];
+				os << ",\n{\"name\": \"" << kindNames[event.kind] << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer.thread
+					<< ", \"ts\": ";
+				writeMicros(os, event.begin);
+				os << ", \"dur\": ";
+				writeMicros(os, event.end-event.begin);
+				os << ", \"args\": {";
+				for(size_t a = 0; a < maxArgs && argNames[event.kind][a] != nullptr; ++a)
+					os << (a > 0 ? ", " : "") << "\"" << argNames[event.kind][a] << "\": " << event.args[a];
+				os << "}}";
+			}
+			if(buffer.recorded > buffer.events.size())
+				os << ",\n{\"name\": \"dropped " << buffer.recorded - buffer.events.size() << " events\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": " << buffer.thread << ", \"ts\": 0}";
+		}
+		os << "\n]}\n";
+	}
+
+}//namespace
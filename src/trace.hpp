@@ -0,0 +1,113 @@
+/* Integer Partition
+ * Computes the number of possible ordered integer partitions with upper bounds
+ * Copyright (C) 2013 Dominik Köppl
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file trace.hpp
+ * @brief Records the jobs and waits of the parallel generator as Chrome trace events, compiled in only with WITH_TRACE
+ * @author Dominik Köppl
+ *
+ * @date 2026-10-19
+ *
+ * Every thread records into its own ring buffer, which keeps the latest events if it overflows.
+ * Trace::json writes the events of all threads in the trace event format of Chrome, which can be opened by Perfetto.
+ * Without WITH_TRACE, the macro TRACE_SCOPE expands to nothing.
+ */
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include "macros.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace IntervalPartition {
+
+	struct Trace {
+		/**
+		 * The recorded kinds of events
+		 */
+		enum Kind {
+			job, //!< computing a piece, with the arguments level, interval, witness_left, witness_right
+			wait_piece, //!< waiting for a piece computed by another job, with the arguments level, interval
+			wait_queue, //!< waiting for the lock of the job queue
+			faulhaber, //!< computing the Faulhaber sum of a piece, with the arguments level, interval
+			kinds
+		};
+		static constexpr size_t maxArgs = 4;
+
+		struct Event {
+			Kind kind;
+			uint64_t begin; //!< in nanoseconds since Trace::start
+			uint64_t end;
+			uint64_t args[maxArgs];
+		};
+
+#ifdef WITH_TRACE
+		static constexpr bool enabled = true;
+#else
+		static constexpr bool enabled = false;
+#endif
+
+		/**
+		 * Discards all recorded events and starts recording
+		 * @param capacity the number of events each thread keeps
+		 * @pre no thread is recording
+		 */
+		static void start(const size_t capacity = 1<<16);
+		/** Stops recording, the recorded events are kept */
+		static void stop();
+		static bool recording();
+		/** @return the nanoseconds since start */
+		static uint64_t now();
+		/** Appends an event to the ring buffer of the calling thread */
+		static void record(const Event& event);
+
+		/**
+		 * Writes the recorded events of all threads as a Chrome trace JSON object
+		 * @pre no thread is recording
+		 */
+		static void json(std::ostream& os);
+
+		/**
+		 * Records its lifetime as an event
+		 */
+		class Scope {
+			Event m_event;
+			const bool m_active;
+			public:
+			Scope(const Kind kind, const uint64_t arg0 = 0, const uint64_t arg1 = 0, const uint64_t arg2 = 0, const uint64_t arg3 = 0)
+				: m_event { kind, 0, 0, { arg0, arg1, arg2, arg3 } }, m_active(recording())
+			{
+				if(m_active) m_event.begin = now();
+			}
+			~Scope() {
+				if(!m_active) return;
+				m_event.end = now();
+				record(m_event);
+			}
+		};
+	};
+
+}//ns
+
+#ifdef WITH_TRACE
+/** Records the enclosing scope, takes the kind followed by its arguments, e.g., TRACE_SCOPE(Trace::wait_piece, level, interval) */
+#define TRACE_SCOPE(...) const IntervalPartition::Trace::Scope MAKE_UNIQUE(traceScope)(__VA_ARGS__)
+#else
+#define TRACE_SCOPE(...)
+#endif
+
+#endif//guard
@@ -60,10 +60,10 @@ Q choose(unsigned int k, unsigned int j)
  * e.g. iterating over the sum
  * Thus it's a naive approach without any technique
  */
-Z barefoot(const IB& n, const unsigned int& p)
+Z barefoot(const Z& n, const unsigned int& p)
 {
 	Z res = 0;
-	for(IB exp = 1; exp <= n; ++exp)
+	for(Z exp = 1; exp <= n; ++exp)
 	{
 		Z rop;
 		mpz_pow_ui(rop.get_mpz_t(), exp.get_mpz_t(), p);
@@ -169,3 +169,31 @@ TEST(Polynom, sumFromZeroToZMinusGamma) {
 	}	
 }
 
+
+TEST(Polynom, InPlaceArithmetic) {
+	IntervalPartition::GMPRandom random(seed);
+	for(size_t p = 1; p < 20; ++p)
+	for(size_t q = 1; q < 20; ++q) {
+		Polynom a(p);
+		Polynom b(q);
+		for(size_t i = 0; i < p; ++i) a[i] = random.get();
+		for(size_t i = 0; i < q; ++i) b[i] = random.get();
+		const Q factor = random.get();
+		Polynom sum(a);
+		sum += b;
+		Polynom diff(a);
+		diff -= b;
+		Polynom fused(a);
+		fused.addmul(b, factor);
+		for(size_t x = 0; x < 10; ++x) {
+			ASSERT_EQ(sum(x), a(x) + b(x));
+			ASSERT_EQ(diff(x), a(x) - b(x));
+			ASSERT_EQ(fused(x), a(x) + factor*b(x));
+			ASSERT_EQ((Polynom(a) + b)(x), sum(x));
+			ASSERT_EQ((Polynom(a) - b)(x), diff(x));
+		}
+		const Q* const coefficients = sum.data();
+		const Polynom moved(std::move(sum));
+		ASSERT_EQ(moved.data(), coefficients);
+	}
+}
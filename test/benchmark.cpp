@@ -5,6 +5,8 @@
 #include "interval_partition.hpp"
 #include <celero/Celero.h>
 #include "naive.hpp"
+#include <atomic>
+#include <cstdlib>
 
 namespace google {}
 namespace gflags {}
@@ -12,7 +14,60 @@ namespace gflags {}
 DEFINE_uint64(threads, std::thread::hardware_concurrency() == 0 ? 1 : std::thread::hardware_concurrency(), "Number of Threads");
 //DEFINE_uint64(threads, 4, "Number of Threads");
 
-CELERO_MAIN
+namespace AllocationCounter {
+	std::atomic<size_t> calls(0); //!< number of allocations and reallocations done by GMP
+	std::atomic<size_t> bytes(0); //!< number of bytes requested by these calls
+
+	void* allocate(size_t size) {
+		++calls;
+		bytes += size;
+		return std::malloc(size);
+	}
+	void* reallocate(void* ptr, size_t, size_t size) {
+		++calls;
+		bytes += size;
+		return std::realloc(ptr, size);
+	}
+	void deallocate(void* ptr, size_t) {
+		std::free(ptr);
+	}
+
+	/**
+	 * Prints the GMP allocations caused by each level of the sweep.
+	 * The polynomial of the first k dimensions is built for every k,
+	 * such that the difference to k-1 is the traffic of the k-th level.
+	 */
+	void report(const unsigned int* const bounds, const size_t bsize) {
+		for(size_t i = 0; i < bsize; ++i) std::cout << (i == 0 ? "{" : ", ") << bounds[i];
+		std::cout << "}" << std::endl;
+		size_t previousCalls = 0, previousBytes = 0;
+		for(size_t k = 1; k <= bsize; ++k) {
+			calls = 0;
+			bytes = 0;
+			IntervalPartition::generateIntervalPartition(bounds, k, false);
+			std::cout << "level " << k << ": " << (calls-std::min<size_t>(calls, previousCalls)) << " allocations, " 
+				<< (bytes-std::min<size_t>(bytes, previousBytes)) << " bytes" << std::endl;
+			previousCalls = calls;
+			previousBytes = bytes;
+		}
+	}
+}
+
+/**
+ * Called with --allocations, the GMP allocations per level of some instances are reported.
+ * Otherwise, the celero benchmarks are run.
+ */
+int main(int argc, char** argv) {
+	if(argc > 1 && std::string(argv[1]) == "--allocations") {
+		IntervalPartition::generateIntervalPartition(std::vector<unsigned int>({2,2}).data(), 2, false); // warm up the static tables
+		mp_set_memory_functions(AllocationCounter::allocate, AllocationCounter::reallocate, AllocationCounter::deallocate);
+		const std::vector<std::vector<unsigned int>> instances = { {3000, 4000, 5000}, {10000, 10000, 10000, 10000, 10000}, {33, 29, 42, 34, 59, 76, 54, 33} };
+		for(const auto& instance : instances) AllocationCounter::report(instance.data(), instance.size());
+		return 0;
+	}
+	celero::Run(argc, argv);
+	return 0;
+}
 
 BASELINE(Binomial, Baseline, 100, 100)
 {
@@ -27,129 +82,13 @@ BASELINE(Faulhaber, Baseline, 10, 100)
     celero::DoNotOptimizeAway(IntervalPartition::Faulhaber(FAULHABER_DIM));
 }
 
-#include "util.hpp"
-
 namespace IntervalPartition {
 	size_t computeValidityIntervals(const unsigned int* const dimensional_upper_bounds, 
 			const size_t dimensions, 
 			bool useSymmetry
 			)
 	{
-		DVLOG(2) << "Interval Partitioning started";
-		for(size_t i = 0; i < dimensions; ++i) {
-			DCHECK_GT(dimensional_upper_bounds[i], 0) << "Every dimensional upper bound has to be > 0";
-		}
-		// maxdim is only used if useSymmetry to decide the cut-off
-		const size_t maxdim = std::accumulate(dimensional_upper_bounds, dimensional_upper_bounds+dimensions,static_cast<size_t>(0)); 
-		vektor<IB> intervalbounds;
-
-		intervalbounds.push_back(dimensional_upper_bounds[0]);
-
-		for(size_t k = 1; k < dimensions; ++k)
-		{
-			DVLOG(2) << "k: " << k;
-
-			vektor<IB> tmp_intervalbounds; //! in this array the interval bounds of the next round (k+1) will be stored
-			vektor<IB> help_intervalbounds;
-			const unsigned int& dimensional_upper_bound = dimensional_upper_bounds[k];
-
-			//if(dimensional_upper_bound > 1) 
-			{ // we do now want a help_intervalbounds-value of 0
-				help_intervalbounds.push_back(dimensional_upper_bound - 1);
-			}
-
-
-			for(const IB& old_intervalbound : intervalbounds)
-				help_intervalbounds.push_back(old_intervalbound + dimensional_upper_bound);
-
-
-			
-			/**
-			 * i : intervalbounds[] index
-			 * j : help_intervalbounds[] index
-			 * witness_right_index, witness_left_index : intervalbounds[] index
-			 * witness_right, witness_left : help_intervalbounds[] value
-			 *
-			 */
-			for(size_t i = 0, j = 0, witness_left_index = 0, witness_right_index = 0; j < help_intervalbounds.size();)
-			{
-
-				const IB& intervalbound = i < intervalbounds.size() ?  intervalbounds[i] : Z_zero;
-				const IB& help_intervalbound = help_intervalbounds[j];
-				
-				const IB& witness_right = get_witness(witness_right_index, intervalbounds);
-				const IB& witness_left = get_witness(witness_left_index, intervalbounds);
-				if(useSymmetry && witness_left >= maxdim/2) break;
-				DCHECK_LE(witness_left_index, intervalbounds.size()+1);
-				DCHECK_LE(witness_right_index, intervalbounds.size()+1);
-
-				DVLOG(2) << "k: " << k << ", i: " << i << ", j: " << j;
-				if(i < intervalbounds.size()) {
-					/**
-					 * We are examining intervalbounds[i] and help_intervalbounds[j] and pop
-					 * that value which is smaller (popping: increment either i or j)
-					 * If both values are the same, we increment both i and j.
-					 * min(intervalbounds[i], help_intervalbounds[j]) is appended to tmp_intervalbounds
-					 */
-					if(intervalbound < help_intervalbound) {
-						tmp_intervalbounds.push_back(intervalbound);
-						if(witness_right < intervalbound) {
-							++witness_right_index;
-						}
-						if(intervalbound > witness_left + dimensional_upper_bound ) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 1, addiere " << intervalbound;
-						++i;
-					}
-					else if(intervalbound > help_intervalbound)
-					{
-						tmp_intervalbounds.push_back(help_intervalbound);
-						if(witness_right < help_intervalbound) {
-							++witness_right_index;
-						}
-						if(help_intervalbound > witness_left + dimensional_upper_bound) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 2, addiere " << help_intervalbound;
-						++j;
-					}
-					else
-					{
-						tmp_intervalbounds.push_back(intervalbound);
-						if(intervalbound > witness_right) {
-							++witness_right_index;
-						}
-						if(intervalbound > witness_left + dimensional_upper_bound) {
-							++witness_left_index;
-						}
-						DVLOG(2) << "Fall 3, addiere " << intervalbound;
-						++i;
-						++j;
-					}
-				} else {
-					/** We have already taken every element of intervalbounds[]. Because help_intervalbounds[] has some larger values, these have to 
-					 *  be examined:
-					 */
-					tmp_intervalbounds.push_back(help_intervalbound);
-					if(help_intervalbound > witness_right && witness_right_index <= intervalbounds.size()) {
-						++witness_right_index;
-					}
-					if(help_intervalbound > witness_left + dimensional_upper_bound) {
-						++witness_left_index;
-					}
-					DVLOG(2) << "Fall 4, addiere " << help_intervalbound;
-					++j;
-				}
-				DVLOG(2) << "Witness: " << "[" << witness_left_index << ", " << witness_right_index << "]";
-				DVLOG(2) << "tmp_intervalbounds: " << tmp_intervalbounds;
-				DVLOG(2) << "intervalbounds: " << intervalbounds;
-
-			}
-			intervalbounds.swap(tmp_intervalbounds);
-			DVLOG(2) << "_old_intervals: " << intervalbounds;
-		}
-		return intervalbounds.size();
+		return SweepPlan(dimensional_upper_bounds, dimensions, useSymmetry).level(dimensions-1).bounds.size();
 	}
 }
 
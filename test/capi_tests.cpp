@@ -0,0 +1,109 @@
+#include "interval_partition_c.h"
+#include "naive.hpp"
+#include <gmpxx.h>
+#include <gtest/gtest.h>
+
+#include "intpartrandom.hpp"
+
+namespace {
+	mpz_class fromWords(const ip_words& result) {
+		mpz_class value;
+		mpz_import(value.get_mpz_t(), result.count, -1, sizeof(uint64_t), 0, 0, result.words);
+		return value;
+	}
+}
+
+TEST_F(IntervalPartitionRandom, CInterfaceBatch) {
+	ip_solver* solver = ip_solver_create(3);
+	ASSERT_NE(solver, nullptr);
+	std::vector<std::vector<unsigned int>> problemBounds;
+	std::vector<ip_problem> problems;
+	std::vector<unsigned long> zs;
+	std::vector<mpz_class> expected;
+	for(size_t steps = 0; steps < 50; ++steps) {
+		next();
+		print();
+		problemBounds.emplace_back(get_bounds(), get_bounds()+bsize);
+		zs.push_back(z);
+		expected.push_back(naive_bounds<mpz_class>(get_bounds(), z, 0, bsize-1));
+	}
+	for(const auto& b : problemBounds) problems.push_back(ip_problem { b.data(), b.size() });
+
+	std::vector<std::vector<char>> buffers(problems.size(), std::vector<char>(64));
+	std::vector<ip_decimal> decimals(problems.size());
+	for(size_t k = 0; k < problems.size(); ++k) decimals[k] = ip_decimal { buffers[k].data(), buffers[k].size(), 0, -1 };
+	ASSERT_EQ(ip_count_batch_decimal(solver, problems.data(), zs.data(), problems.size(), decimals.data()), 0u);
+
+	std::vector<std::vector<uint64_t>> words(problems.size(), std::vector<uint64_t>(4));
+	std::vector<ip_words> results(problems.size());
+	for(size_t k = 0; k < problems.size(); ++k) results[k] = ip_words { words[k].data(), words[k].size(), 0, -1 };
+	ASSERT_EQ(ip_count_batch_words(solver, problems.data(), zs.data(), problems.size(), results.data()), 0u);
+
+	for(size_t k = 0; k < problems.size(); ++k) {
+		ASSERT_EQ(decimals[k].status, IP_OK);
+		ASSERT_EQ(mpz_class(decimals[k].buffer), expected[k]);
+		ASSERT_EQ(decimals[k].length, expected[k].get_str().size());
+		ASSERT_EQ(results[k].status, IP_OK);
+		ASSERT_EQ(fromWords(results[k]), expected[k]);
+	}
+	ip_solver_destroy(solver);
+}
+
+TEST_F(IntervalPartitionRandom, CInterfaceMany) {
+	ip_solver* solver = ip_solver_create(1);
+	ASSERT_NE(solver, nullptr);
+	for(size_t steps = 0; steps < 20; ++steps) {
+		next();
+		print();
+		bounds[0] = 1; // covers the removal of bounds equal to one
+		const ip_problem problem { bounds, bsize };
+		const unsigned long total = std::accumulate(bounds, bounds+bsize, 0UL);
+		std::vector<unsigned long> zs;
+		for(unsigned long s = 0; s <= total+1; ++s) zs.push_back(s);
+		std::vector<std::vector<uint64_t>> words(zs.size(), std::vector<uint64_t>(4));
+		std::vector<ip_words> results(zs.size());
+		for(size_t k = 0; k < zs.size(); ++k) results[k] = ip_words { words[k].data(), words[k].size(), 0, -1 };
+		ASSERT_EQ(ip_count_many_words(solver, &problem, zs.data(), zs.size(), results.data()), 0u);
+		for(size_t k = 0; k < zs.size(); ++k) {
+			ASSERT_EQ(results[k].status, IP_OK);
+			ASSERT_EQ(fromWords(results[k]), naive_bounds<mpz_class>(bounds, zs[k], 0, bsize-1));
+		}
+	}
+	ip_solver_destroy(solver);
+}
+
+TEST(CInterface, BufferTooSmall) {
+	ip_solver* solver = ip_solver_create(1);
+	const unsigned int bounds[] = { 100, 100, 100, 100, 100 };
+	const ip_problem problem { bounds, 5 };
+	const mpz_class expected = naive_bounds<mpz_class>(bounds, 250, 0, 4);
+
+	char small[4];
+	ip_decimal decimal { small, sizeof(small), 0, -1 };
+	ASSERT_EQ(ip_count_decimal(solver, &problem, 250, &decimal), IP_BUFFER_TOO_SMALL);
+	ASSERT_EQ(decimal.status, IP_BUFFER_TOO_SMALL);
+	ASSERT_GE(decimal.length, expected.get_str().size()+1);
+	std::vector<char> buffer(decimal.length);
+	decimal.buffer = buffer.data();
+	decimal.capacity = buffer.size();
+	ASSERT_EQ(ip_count_decimal(solver, &problem, 250, &decimal), IP_OK);
+	ASSERT_EQ(mpz_class(decimal.buffer), expected);
+
+	ip_words words { nullptr, 0, 0, -1 };
+	ASSERT_EQ(ip_count_words(solver, &problem, 0, &words), IP_BUFFER_TOO_SMALL); // the result 1 needs one word
+	ASSERT_EQ(words.count, 1u);
+	ASSERT_EQ(ip_count_words(solver, &problem, 251+250, &words), IP_OK); // the result 0 needs no word
+	ASSERT_EQ(words.count, 0u);
+	ip_solver_destroy(solver);
+}
+
+TEST(CInterface, InvalidArgument) {
+	ip_solver* solver = ip_solver_create(1);
+	ip_decimal decimal { nullptr, 0, 0, -1 };
+	ASSERT_EQ(ip_count_decimal(solver, nullptr, 3, &decimal), IP_INVALID_ARGUMENT);
+	ASSERT_EQ(decimal.status, IP_INVALID_ARGUMENT);
+	const ip_problem problem { nullptr, 2 };
+	ASSERT_EQ(ip_count_decimal(solver, &problem, 3, &decimal), IP_INVALID_ARGUMENT);
+	ASSERT_EQ(ip_count_decimal(nullptr, &problem, 3, &decimal), IP_INVALID_ARGUMENT);
+	ip_solver_destroy(solver);
+}
@@ -0,0 +1,154 @@
+#include "composition_enumerator.hpp"
+#include "naive.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+
+#include "intpartrandom.hpp"
+
+using IntervalPartition::CompositionEnumerator;
+
+TEST_F(IntervalPartitionRandom, EnumerateLexicographic) {
+	for(size_t steps = 0; steps < 50; ++steps) {
+		next();
+		print();
+		const mpz_class expected = naive_bounds<mpz_class>(bounds, z, 0, bsize-1);
+		if(expected > 20000) continue; // keeps the exhaustive check cheap
+		std::vector<unsigned int> previous;
+		std::vector<unsigned int> composition(bsize);
+		mpz_class count = 0;
+		CompositionEnumerator enumerator(bounds, bsize, z);
+		while(enumerator.next(composition.data())) {
+			ASSERT_EQ(std::accumulate(composition.begin(), composition.end(), 0UL), z);
+			for(size_t i = 0; i < bsize; ++i) ASSERT_LE(composition[i], bounds[i]);
+			ASSERT_TRUE(previous.empty() || std::lexicographical_compare(previous.begin(), previous.end(), composition.begin(), composition.end()));
+			previous = composition;
+			++count;
+		}
+		ASSERT_EQ(count, expected);
+		ASSERT_FALSE(enumerator.next(composition.data()));
+	}
+}
+
+TEST_F(IntervalPartitionRandom, EnumerateGray) {
+	for(size_t steps = 0; steps < 50; ++steps) {
+		next();
+		print();
+		const mpz_class expected = naive_bounds<mpz_class>(bounds, z, 0, bsize-1);
+		if(expected > 20000) continue; // keeps the exhaustive check cheap
+		std::vector<std::vector<unsigned int>> visited;
+		std::vector<unsigned int> composition(bsize);
+		CompositionEnumerator enumerator(bounds, bsize, z, CompositionEnumerator::Order::gray);
+		while(enumerator.next(composition.data())) {
+			ASSERT_EQ(std::accumulate(composition.begin(), composition.end(), 0UL), z);
+			if(!visited.empty()) { // a single unit moves from one dimension to another
+				unsigned long distance = 0;
+				for(size_t i = 0; i < bsize; ++i)
+					distance += composition[i] > visited.back()[i] ? composition[i] - visited.back()[i] : visited.back()[i] - composition[i];
+				ASSERT_EQ(distance, 2);
+			}
+			visited.push_back(composition);
+		}
+		ASSERT_EQ(visited.size(), expected);
+		std::sort(visited.begin(), visited.end());
+		ASSERT_TRUE(std::adjacent_find(visited.begin(), visited.end()) == visited.end());
+	}
+}
+
+TEST_F(IntervalPartitionRandom, EnumerateSplit) {
+	for(size_t steps = 0; steps < 50; ++steps) {
+		if(steps % 2 == 0) next();
+		else nextWithSmallBounds();
+		print();
+		const size_t parts = 1 + steps % 5;
+		const auto ranges = CompositionEnumerator::split(bounds, bsize, z, parts);
+		ASSERT_LE(ranges.size(), parts);
+		std::vector<unsigned int> composition(bsize);
+		mpz_class count = 0;
+		for(size_t r = 0; r < ranges.size(); ++r) {
+			if(r > 0) {
+				ASSERT_EQ(ranges[r-1].head_last+1, ranges[r].head_first);
+			}
+			mpz_class range_count = 0;
+			CompositionEnumerator enumerator(bounds, bsize, z, ranges[r]);
+			while(enumerator.next(composition.data())) {
+				ASSERT_GE(composition[0], ranges[r].head_first);
+				ASSERT_LE(composition[0], ranges[r].head_last);
+				++range_count;
+			}
+			ASSERT_EQ(range_count, ranges[r].count);
+			count += range_count;
+		}
+		ASSERT_EQ(count, naive_bounds<mpz_class>(bounds, z, 0, bsize-1));
+	}
+}
+
+TEST(CompositionEnumerator, SplitSmallBounds) {
+	const std::vector<std::vector<unsigned int>> instances { { 5, 3, 1 }, { 2, 1, 1 }, { 3, 0, 2 }, { 0, 1 }, { 4, 1, 0, 1, 3 } };
+	for(const auto& bounds : instances)
+		for(unsigned long z = 0; z <= std::accumulate(bounds.begin(), bounds.end(), 1UL); ++z) {
+			const auto ranges = CompositionEnumerator::split(bounds.data(), bounds.size(), z, 2);
+			mpz_class count = 0;
+			for(const auto& range : ranges) count += range.count;
+			ASSERT_EQ(count, naive_bounds<mpz_class>(bounds.data(), z, 0, bounds.size()-1));
+		}
+}
+
+#include "composition_rank.hpp"
+using IntervalPartition::CompositionRanker;
+
+namespace {
+	/**
+	 * Compares rank and unrank with the lexicographic enumeration
+	 */
+	void checkRankUnrank(const unsigned int* bounds, const size_t bsize, const unsigned long z) {
+		const CompositionRanker ranker(bounds, bsize, z);
+		ASSERT_EQ(ranker.count(), naive_bounds<mpz_class>(bounds, z, 0, bsize-1));
+		if(ranker.count() > 2000) return; // keeps the exhaustive check cheap
+		std::vector<unsigned int> composition(bsize);
+		std::vector<unsigned int> unranked(bsize);
+		std::vector<mpz_class> indices;
+		std::vector<unsigned int> expected;
+		mpz_class index = 0;
+		CompositionEnumerator enumerator(bounds, bsize, z);
+		while(enumerator.next(composition.data())) {
+			ASSERT_EQ(ranker.rank(composition.data()), index);
+			ranker.unrank(index, unranked.data());
+			ASSERT_EQ(composition, unranked);
+			indices.push_back(index);
+			expected.insert(expected.end(), composition.begin(), composition.end());
+			++index;
+		}
+		ASSERT_EQ(index, ranker.count());
+
+		// batch unranking with indices in an arbitrary order and with duplicates
+		std::vector<size_t> order(indices.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::reverse(order.begin(), order.end());
+		if(!order.empty()) order.push_back(order.size()/2);
+		std::vector<mpz_class> shuffled;
+		for(const size_t& i : order) shuffled.push_back(indices[i]);
+		std::vector<unsigned int> batch(shuffled.size()*bsize);
+		ranker.unrank(shuffled.data(), shuffled.size(), batch.data());
+		for(size_t i = 0; i < order.size(); ++i)
+			ASSERT_TRUE(std::equal(batch.begin()+i*bsize, batch.begin()+(i+1)*bsize, expected.begin()+order[i]*bsize));
+	}
+}
+
+TEST_F(IntervalPartitionRandom, RankUnrank) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		if(steps % 2 == 0) next();
+		else nextWithSmallBounds();
+		print();
+		checkRankUnrank(bounds, bsize, z);
+		if(HasFatalFailure()) return;
+	}
+}
+
+TEST(CompositionRanker, SmallBounds) {
+	const std::vector<std::vector<unsigned int>> instances { { 5, 1, 3 }, { 1, 2, 1 }, { 1, 1 }, { 1 }, { 0 }, { 0, 3 }, { 4, 0, 1, 2 }, { 1, 0, 1, 5, 1 } };
+	for(const auto& bounds : instances)
+		for(unsigned long z = 0; z <= std::accumulate(bounds.begin(), bounds.end(), 1UL); ++z) {
+			checkRankUnrank(bounds.data(), bounds.size(), z);
+			if(::testing::Test::HasFatalFailure()) return;
+		}
+}
@@ -0,0 +1,92 @@
+#include "protocol.hpp"
+#include "naive.hpp"
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <thread>
+
+#include "intpartrandom.hpp"
+
+namespace {
+	Daemon::IntervalledPolynom build(const Daemon::key_type& key) {
+		return IntervalPartition::generateIntervalPartition(key.data(), key.size(), true);
+	}
+
+	/**
+	 * Serves a Daemon::Server on one end of a socket pair, and sends requests over the other end
+	 */
+	class Connection {
+		int m_fds[2];
+		std::thread m_serving;
+		public:
+		Connection(Daemon::Server& server) {
+			EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, m_fds), 0);
+			m_serving = std::thread(Daemon::serve, m_fds[1], std::ref(server));
+		}
+		~Connection() {
+			close(m_fds[0]);
+			m_serving.join();
+		}
+		std::string request(const std::string& message) {
+			const uint32_t length = message.size();
+			EXPECT_TRUE(Daemon::writeAll(m_fds[0], reinterpret_cast<const char*>(&length), sizeof(length)));
+			EXPECT_TRUE(Daemon::writeAll(m_fds[0], message.data(), message.size()));
+			uint32_t responseLength = 0;
+			EXPECT_TRUE(Daemon::readAll(m_fds[0], reinterpret_cast<char*>(&responseLength), sizeof(responseLength)));
+			std::string response(responseLength, '\0');
+			EXPECT_TRUE(Daemon::readAll(m_fds[0], &response[0], responseLength));
+			return response;
+		}
+	};
+
+	std::string countRequest(const unsigned long z, const unsigned int* bounds, const size_t bsize) {
+		std::ostringstream ss;
+		ss << "count " << z;
+		for(size_t i = 0; i < bsize; ++i) ss << ' ' << bounds[i];
+		return ss.str();
+	}
+}
+
+TEST_F(IntervalPartitionRandom, DaemonCount) {
+	Daemon::Server server(1 << 26, build);
+	Connection connection(server);
+	for(size_t steps = 0; steps < 20; ++steps) {
+		next();
+		print();
+		ASSERT_EQ(connection.request(countRequest(z, bounds, bsize)), naive_bounds<mpz_class>(bounds, z, 0, bsize-1).get_str());
+
+		const uint64_t misses = server.cache().misses;
+		const uint64_t hits = server.cache().hits;
+		std::reverse(bounds, bounds+bsize);
+		const unsigned long otherZ = z/2;
+		ASSERT_EQ(connection.request(countRequest(otherZ, bounds, bsize)), naive_bounds<mpz_class>(bounds, otherZ, 0, bsize-1).get_str());
+		EXPECT_EQ(server.cache().misses, misses); // the same bounds in a different order are answered from the cache
+		if(otherZ > 0) { EXPECT_EQ(server.cache().hits, hits+1); }
+	}
+	EXPECT_NE(connection.request("stats").find("\"errors\": 0"), std::string::npos);
+}
+
+TEST(Daemon, ErrorReplies) {
+	Daemon::Server server(1 << 26, build);
+	Connection connection(server);
+	EXPECT_EQ(connection.request("count 5 4 -2"), "error: bounds have to be non-negative integers");
+	EXPECT_EQ(connection.request("count -3 4"), "error: bounds have to be non-negative integers");
+	EXPECT_EQ(connection.request("count 3 4 x"), "error: bounds have to be non-negative integers");
+	EXPECT_EQ(connection.request("count 3 4 99999999999"), "error: bounds have to be non-negative integers");
+	EXPECT_EQ(connection.request("count"), "error: expected count z i_0 [i_1 [...]]");
+	EXPECT_EQ(connection.request("sum 3 4"), "error: unknown command sum");
+	EXPECT_EQ(connection.request("count 3 4 2"), "3");
+	EXPECT_NE(connection.request("stats").find("\"requests\": 8, \"errors\": 6"), std::string::npos);
+}
+
+TEST(Daemon, FailedBuild) {
+	size_t builds = 0;
+	Daemon::Server server(1 << 26, [&builds] (const Daemon::key_type& key) {
+		if(builds++ == 0) throw std::bad_alloc();
+		return build(key);
+	});
+	Connection connection(server);
+	EXPECT_EQ(connection.request("count 3 4 2").compare(0, 6, "error:"), 0);
+	EXPECT_EQ(connection.request("count 3 4 2"), "3"); // the failed key is built again
+	EXPECT_EQ(connection.request("count 2 2 4"), "3");
+	EXPECT_EQ(builds, 2u);
+}
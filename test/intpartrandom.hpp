@@ -28,6 +28,18 @@ class IntervalPartitionRandom : public ::testing::Test {
 			bounds[i] = urn_distro(generator);
 		z = std::uniform_int_distribution<unsigned long>(0, std::accumulate(bounds, bounds+bsize,0UL)+1)(generator);
 	}
+	/**
+	 * Like next, but replaces some bounds with 0 or 1, which the sweep handles only after stripping them
+	 */
+	void nextWithSmallBounds() {
+		next();
+		std::uniform_int_distribution<int> small_distro(0,7);
+		for(size_t i = 0; i < bsize; ++i) {
+			const int small = small_distro(generator);
+			if(small < 2) bounds[i] = small;
+		}
+		z = std::uniform_int_distribution<unsigned long>(0, std::accumulate(bounds, bounds+bsize,0UL)+1)(generator);
+	}
 	unsigned long get_z() const { return z; }
 	unsigned int* get_bounds() { return bounds; }
 	size_t get_bsize() const { return bsize; }
@@ -1,5 +1,12 @@
 #include "interval_partition.hpp"
+#include "approximate_partition.hpp"
+#include "constrained_partition.hpp"
+#include "cost_estimate.hpp"
 #include "naive.hpp"
+#include "probability.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include "sum_from_zero_cacher.hpp"
 #include <gtest/gtest.h>
 
 TEST(IntervalPartition, Example) {
@@ -124,6 +131,247 @@ TEST_F(IntervalPartitionRandom, MirrorCheck) {
 	}
 }
 
+TEST_F(IntervalPartitionRandom, FrozenLookup) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		print();
+		const IntervalPartition::IntervalledPolynom intervalledPolynom = IntervalPartition::generateIntervalPartition(bounds, bsize, false);
+		ASSERT_TRUE(intervalledPolynom.frozen());
+		const auto& ibounds = intervalledPolynom.bounds();
+		for(IB x = 0; x <= ibounds.back()+1; ++x) {
+			const auto it = std::lower_bound(ibounds.begin(), ibounds.end(), x);
+			const IntervalPartition::Polynom& expected = it == ibounds.end() ? IntervalPartition::Polynom::zero : intervalledPolynom.piece(it-ibounds.begin());
+			ASSERT_EQ(&intervalledPolynom.at(x), &expected);
+		}
+		ASSERT_EQ(&intervalledPolynom.at(Z(ibounds.back())), &intervalledPolynom.piece(ibounds.size()-1));
+		ASSERT_EQ(&intervalledPolynom.at(Z(-1)), &IntervalPartition::Polynom::zero);
+	}
+}
+
+
+TEST_F(IntervalPartitionRandom, RangeSum) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		print();
+		IntervalPartition::IntervalledPolynom intervalledPolynom = IntervalPartition::generateIntervalPartition(bounds, bsize, false);
+		intervalledPolynom.buildPrefixSums();
+		const IB maxdim = intervalledPolynom.bounds().back();
+		std::vector<Q> prefix(1, 0); // prefix[x] is the sum of the counts of 0, ..., x-1
+		for(IB x = 0; x <= maxdim+1; ++x) prefix.push_back(prefix.back() + naive_bounds<mpz_class>(bounds, x, 0, bsize-1));
+		for(IB z1 = 0; z1 <= maxdim+1; ++z1) {
+			for(IB z2 = z1; z2 <= maxdim+1; ++z2) {
+				ASSERT_EQ(intervalledPolynom.range_sum(z1, z2), prefix[z2+1] - prefix[z1]) << "[" << z1 << ", " << z2 << "]";
+			}
+		}
+		ASSERT_EQ(intervalledPolynom.range_sum(1, 0), 0);
+		ASSERT_EQ(intervalledPolynom.prefix_sum(Z(-1)), 0);
+		ASSERT_EQ(intervalledPolynom.prefix_sum(Z(maxdim) * maxdim * maxdim * maxdim * 1000000), prefix.back());
+	}
+}
+
+TEST_F(IntervalPartitionRandom, Quantile) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		print();
+		IntervalPartition::IntervalledPolynom intervalledPolynom = IntervalPartition::generateIntervalPartition(bounds, bsize, false);
+		intervalledPolynom.buildPrefixSums();
+		std::vector<Q> cdf; // cdf[x] is the sum of the counts of 0, ..., x
+		for(IB x = 0; x <= intervalledPolynom.bounds().back(); ++x) cdf.push_back((x == 0 ? Q(0) : cdf.back()) + naive_bounds<mpz_class>(bounds, x, 0, bsize-1));
+		ASSERT_EQ(intervalledPolynom.total_sum(), cdf.back());
+
+		std::vector<Q> qs;
+		for(size_t k = 0; k <= 20; ++k) qs.push_back(cdf.back() * k / 20); // fractional quantiles
+		for(size_t k = 0; k < 20; ++k) qs.push_back(cdf[(k * 7919) % cdf.size()]); // hitting the sums exactly
+		std::vector<IB> zs(qs.size());
+		intervalledPolynom.quantiles(qs.data(), qs.size(), zs.data());
+		for(size_t i = 0; i < qs.size(); ++i) {
+			const IB expected = std::distance(cdf.begin(), std::lower_bound(cdf.begin(), cdf.end(), qs[i]));
+			ASSERT_EQ(intervalledPolynom.quantile(qs[i]), expected) << "q = " << qs[i];
+			ASSERT_EQ(zs[i], expected) << "q = " << qs[i];
+		}
+	}
+}
+
+TEST_F(IntervalPartitionRandom, SweepPlan) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		print();
+		for(const bool useSymmetry : { false, true }) {
+			const IntervalPartition::SweepPlan plan(bounds, bsize, useSymmetry);
+			IntervalPartition::SumFromZeroCacher sumcacher;
+			vektor<IntervalPartition::IntervalledPolynom> levels;
+			IntervalPartition::IntervalledPolynom intervalledPolynom = IntervalPartition::generateIntervalPartition(plan, sumcacher, &levels);
+			ASSERT_EQ(levels.size(), plan.dimensions());
+			size_t pieces = 0;
+			for(size_t k = 0; k < levels.size(); ++k) {
+				ASSERT_TRUE(levels[k].bounds() == plan.level(k).bounds);
+				pieces += levels[k].bounds().size();
+			}
+			ASSERT_EQ(plan.pieces(), pieces);
+			IntervalPartition::IntervalledPolynom sequential = IntervalPartition::generateIntervalPartition(bounds, bsize, useSymmetry);
+			ASSERT_TRUE(intervalledPolynom == sequential);
+			IntervalPartition::IntervalledPolynom parallel = IntervalPartition::generateParallelIntervalPartition(plan, 2);
+			ASSERT_TRUE(intervalledPolynom == parallel);
+		}
+	}
+}
+
+
+TEST_F(IntervalPartitionRandom, SumFromZeroTable) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		print();
+		const IntervalPartition::SweepPlan plan(bounds, bsize, false);
+		vektor<IntervalPartition::IntervalledPolynom> levels;
+		IntervalPartition::generateIntervalPartition(plan, &levels);
+		IntervalPartition::SumFromZeroCacher sumcacher;
+		for(const IntervalPartition::IntervalledPolynom& level : levels) {
+			const vektor<IB>& intervalbounds = level.bounds();
+			IntervalPartition::SumFromZeroTable table, cachedTable;
+			table.assign(level, nullptr);
+			cachedTable.assign(level, &sumcacher);
+			ASSERT_EQ(table.size(), intervalbounds.size());
+			for(size_t i = 0; i < table.size(); ++i) {
+				ASSERT_TRUE(table[i] == IntervalPartition::sumFromZeroToUpper(level.piece(i)));
+				ASSERT_TRUE(cachedTable[i] == table[i]);
+			}
+			for(size_t from = 0; from <= table.size(); ++from) {
+				Z total = 0;
+				for(size_t to = from; to <= table.size(); ++to) {
+					ASSERT_EQ(table.rangeTotal(from, to), total);
+					ASSERT_EQ(cachedTable.rangeTotal(from, to), total);
+					if(to == table.size()) break;
+					for(IB x = to == 0 ? 0 : intervalbounds[to-1]+1; x <= intervalbounds[to]; ++x) total += level(x).get_num();
+				}
+			}
+		}
+	}
+}
+
+
+TEST_F(IntervalPartitionRandom, CostEstimate) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		print();
+		const IntervalPartition::SweepPlan plan(bounds, bsize, false);
+		const IntervalPartition::CostEstimate estimate = IntervalPartition::estimateCost(plan);
+		IntervalPartition::SumFromZeroCacher sumcacher;
+		vektor<IntervalPartition::IntervalledPolynom> levels;
+		IntervalPartition::generateIntervalPartition(plan, sumcacher, &levels);
+		ASSERT_EQ(estimate.levels.size(), levels.size());
+		for(size_t k = 0; k < levels.size(); ++k) {
+			const IntervalPartition::LevelCost& level = estimate.levels[k];
+			ASSERT_EQ(level.intervals, levels[k].bounds().size());
+			ASSERT_EQ(level.degree, k);
+			if(k > 0) { ASSERT_GT(level.operations, 0); }
+			ASSERT_LE(level.bytes, estimate.peakBytes);
+			for(const IntervalPartition::Polynom& p : levels[k].polynomials()) {
+				for(const Q& coeff : p) {
+					ASSERT_LE(mpz_sizeinbase(coeff.get_num_mpz_t(), 2) + mpz_sizeinbase(coeff.get_den_mpz_t(), 2), level.coefficientBits) << "level " << k;
+				}
+			}
+		}
+	}
+	const IntervalPartition::CostModel model = IntervalPartition::calibrateCostModel(0.01);
+	ASSERT_GE(model.nanosPerOperation, 0);
+	ASSERT_GE(model.nanosPerLimb, 0);
+}
+
+
+TEST_F(IntervalPartitionRandom, Stats) {
+	for(size_t steps = 0; steps < 20; ++steps) {
+		next();
+		print();
+		const IntervalPartition::SweepPlan plan(bounds, bsize, false);
+		for(const size_t threads : { 1, 3 }) {
+			IntervalPartition::Stats::reset();
+			if(threads == 1) {
+				IntervalPartition::SumFromZeroCacher sumcacher;
+				IntervalPartition::generateIntervalPartition(plan, sumcacher);
+			} else {
+				IntervalPartition::generateParallelIntervalPartition(plan, threads);
+			}
+			const IntervalPartition::Stats stats = IntervalPartition::Stats::collect();
+			if(!IntervalPartition::Stats::enabled) {
+				ASSERT_TRUE(stats.intervals.empty());
+				ASSERT_EQ(stats.jobs, 0u);
+				continue;
+			}
+			ASSERT_EQ(stats.intervals.size(), plan.dimensions());
+			for(size_t k = 0; k < plan.dimensions(); ++k) ASSERT_EQ(stats.intervals[k], plan.level(k).bounds.size());
+			ASSERT_EQ(stats.jobs, plan.pieces()-1);
+			const size_t summedPieces = plan.pieces() - plan.level(plan.dimensions()-1).bounds.size(); // every piece but those of the last level is summed up
+			if(threads == 1) {
+				ASSERT_EQ(stats.cacheHits + stats.cacheMisses, summedPieces);
+				ASSERT_EQ(stats.sums, stats.cacheMisses);
+			} else {
+				ASSERT_EQ(stats.sums, summedPieces);
+			}
+			ASSERT_GT(stats.nanos[IntervalPartition::Stats::sweep], 0u);
+		}
+		if(!IntervalPartition::Stats::enabled) continue;
+		const IntervalPartition::IntervalledPolynom ip = IntervalPartition::generateIntervalPartition(plan);
+		IntervalPartition::Stats::reset();
+		ip(0);
+		ASSERT_GT(IntervalPartition::Stats::collect().nanos[IntervalPartition::Stats::canonicalize], 0u);
+	}
+}
+
+
+TEST_F(IntervalPartitionRandom, Trace) {
+	for(size_t steps = 0; steps < 20; ++steps) {
+		next();
+		print();
+		const IntervalPartition::SweepPlan plan(bounds, bsize, false);
+		IntervalPartition::Trace::start();
+		IntervalPartition::generateParallelIntervalPartition(plan, 3);
+		IntervalPartition::Trace::stop();
+		std::ostringstream json;
+		IntervalPartition::Trace::json(json);
+		size_t jobs = 0;
+		for(size_t pos = json.str().find("\"name\": \"job\""); pos != std::string::npos; pos = json.str().find("\"name\": \"job\"", pos+1)) ++jobs;
+		ASSERT_EQ(jobs, IntervalPartition::Trace::enabled ? plan.pieces()-1 : 0);
+		if(IntervalPartition::Trace::enabled && plan.dimensions() > 2) { // the jobs of the last level do not compute sums
+			ASSERT_NE(json.str().find("\"name\": \"faulhaber\""), std::string::npos);
+		}
+	}
+	IntervalPartition::Trace::start(4); // the ring buffers keep only the latest events
+	const unsigned int ringBounds[] = { 20, 30, 40, 50, 60 };
+	IntervalPartition::generateParallelIntervalPartition(ringBounds, 5, false, 2);
+	IntervalPartition::Trace::stop();
+	std::ostringstream json;
+	IntervalPartition::Trace::json(json);
+	ASSERT_EQ(json.str().find("dropped") != std::string::npos, IntervalPartition::Trace::enabled);
+}
+
+
+TEST_F(IntervalPartitionRandom, CriticalPath) {
+	for(size_t steps = 0; steps < 50; ++steps) {
+		next();
+		print();
+		const IntervalPartition::SweepPlan plan(bounds, bsize, true);
+		vektor<vektor<double>> jobSeconds;
+		IntervalPartition::generateParallelIntervalPartition(plan, 1, &jobSeconds);
+		ASSERT_EQ(jobSeconds.size(), plan.dimensions());
+		double work = 0;
+		double longest = 0;
+		for(size_t k = 1; k < plan.dimensions(); ++k) {
+			ASSERT_EQ(jobSeconds[k].size(), plan.level(k).bounds.size());
+			for(const double job : jobSeconds[k]) {
+				work += job;
+				longest = std::max(longest, job);
+			}
+		}
+		const double criticalPath = plan.criticalPath(jobSeconds);
+		ASSERT_LE(criticalPath, work*(1+1e-9));
+		ASSERT_GE(criticalPath, longest);
+
+		for(auto& level : jobSeconds) std::fill(level.begin(), level.end(), 1.0); // counts the jobs on the longest chain
+		ASSERT_LE(plan.criticalPath(jobSeconds), plan.dimensions()-1);
+		if(plan.dimensions() > 1) { ASSERT_GE(plan.criticalPath(jobSeconds), 1); }
+	}
+}
+
 
 TEST_F(IntervalPartitionRandom, ParallelCheck) {
 
@@ -145,3 +393,160 @@ TEST_F(IntervalPartitionRandom, ParallelCheck) {
 		}
 	}
 }
+
+
+TEST_F(IntervalPartitionRandom, NumberOfPartitionsWithOnes) {
+	IntervalPartition::SumFromZeroCacher sumcacher;
+	for(size_t steps = 0; steps < 200; ++steps) {
+		next();
+		for(size_t i = 0; i < bsize; i += 2) bounds[i] = 1; // dimensions of size 1 are handled separately
+		print();
+		const size_t maxdim = std::accumulate(bounds, bounds+bsize, static_cast<size_t>(0));
+		std::vector<unsigned int> copy(bounds, bounds+bsize);
+		for(size_t x = 0; x <= maxdim+1; ++x) {
+			const auto naive_value = naive_bounds<mpz_class>(bounds, x, 0, bsize-1);
+			std::copy(bounds, bounds+bsize, copy.begin());
+			ASSERT_EQ(IntervalPartition::number_of_interval_partitions(copy.data(), bsize, x, 1), naive_value);
+			std::copy(bounds, bounds+bsize, copy.begin());
+			ASSERT_EQ(IntervalPartition::number_of_interval_partitions(copy.data(), bsize, x, sumcacher), naive_value);
+		}
+	}
+}
+
+
+/**
+ * Adds more dimensions of size 1 than the precomputed binomial coefficients cover,
+ * and compares with the convolution of the polynomial of the other dimensions with the binomial coefficients.
+ */
+TEST_F(IntervalPartitionRandom, ManyOnes) {
+	for(size_t steps = 0; steps < 20; ++steps) {
+		if(steps == 0) { // with long intervals, such that the forward differences are used
+			delete [] bounds;
+			bsize = 3;
+			bounds = new unsigned int[bsize] { 100, 200, 300 };
+		} else {
+			next();
+		}
+		print();
+		const size_t boundSum = std::accumulate(bounds, bounds+bsize, static_cast<size_t>(0));
+		const IntervalPartition::IntervalledPolynom intervalledPolynom = IntervalPartition::generateIntervalPartition(bounds, bsize, false);
+		for(const size_t ones : { 7, 250 }) {
+			std::vector<unsigned int> withOnes(bounds, bounds+bsize);
+			withOnes.insert(withOnes.end(), ones, 1);
+			for(size_t x = 0; x <= boundSum+ones+1; x += 1 + (boundSum+ones)/40) {
+				Z expected = 0;
+				for(size_t k = 0; k <= std::min(x, ones); ++k) {
+					Z binomial;
+					mpz_bin_uiui(binomial.get_mpz_t(), ones, k);
+					if(x-k <= boundSum) expected += binomial * intervalledPolynom(static_cast<IB>(x-k)).get_num();
+				}
+				ASSERT_EQ(IntervalPartition::number_of_interval_partitions(withOnes.data(), withOnes.size(), x, 1), expected);
+			}
+		}
+	}
+}
+
+/**
+ * Draws lower bounds and forbidden values for random upper bounds,
+ * and compares with the counts obtained by convolving the admissible values of every dimension one after another.
+ */
+TEST_F(IntervalPartitionRandom, Constrained) {
+	std::default_random_engine draw;
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		print();
+		std::vector<unsigned int> lower(bsize);
+		vektor<vektor<unsigned int>> forbidden(bsize);
+		for(size_t i = 0; i < bsize; ++i) {
+			lower[i] = std::uniform_int_distribution<unsigned int>(0, bounds[i])(draw);
+			const size_t count = std::uniform_int_distribution<size_t>(0, steps % 3)(draw);
+			for(size_t j = 0; j < count; ++j) forbidden[i].push_back(std::uniform_int_distribution<unsigned int>(0, bounds[i]+1)(draw));
+		}
+		std::vector<Z> expected(1, 1); // expected[x] is the number of compositions of x into the dimensions seen so far
+		for(size_t i = 0; i < bsize; ++i) {
+			std::vector<Z> convolved(expected.size() + bounds[i], 0);
+			for(unsigned int value = lower[i]; value <= bounds[i]; ++value) {
+				if(std::find(forbidden[i].begin(), forbidden[i].end(), value) != forbidden[i].end()) continue;
+				for(size_t x = 0; x < expected.size(); ++x) convolved[x+value] += expected[x];
+			}
+			expected.swap(convolved);
+		}
+		const IntervalPartition::IntervalledPolynom intervalledPolynom = IntervalPartition::generateConstrainedPartition(lower.data(), bounds, forbidden.data(), bsize);
+		for(size_t x = 0; x < expected.size()+2; ++x) {
+			const Z count = x < expected.size() ? expected[x] : 0;
+			ASSERT_EQ(intervalledPolynom(static_cast<IB>(x)), count) << "x = " << x;
+			ASSERT_EQ(IntervalPartition::number_of_constrained_partitions(lower.data(), bounds, forbidden.data(), bsize, x), count) << "x = " << x;
+		}
+	}
+}
+
+TEST_F(IntervalPartitionRandom, Probability) {
+	for(size_t steps = 0; steps < 100; ++steps) {
+		next();
+		for(size_t i = 0; i < bsize; i += 3) bounds[i] = steps % 3; // bounds of 0 and 1 are not swept
+		print();
+		const IntervalPartition::PartitionProbability probability(bounds, bsize, 1 + steps % 2);
+		Z total = 1;
+		for(size_t i = 0; i < bsize; ++i) total *= bounds[i] + 1;
+		ASSERT_EQ(probability.total(), total);
+		const size_t maxdim = std::accumulate(bounds, bounds+bsize, static_cast<size_t>(0));
+		std::vector<unsigned long> zs;
+		for(unsigned long x = 0; x <= maxdim+1; ++x) zs.push_back(x);
+		std::vector<double> doubles(zs.size());
+		probability.probabilities(zs.data(), zs.size(), doubles.data());
+		for(const unsigned long x : zs) {
+			Q exact(naive_bounds<mpz_class>(bounds, x, 0, bsize-1), total);
+			exact.canonicalize();
+			ASSERT_EQ(probability.count(x), exact * total);
+			ASSERT_NEAR(probability.probability<double>(x), exact.get_d(), exact.get_d() * 1e-15);
+			ASSERT_EQ(doubles[x], probability.probability<double>(x));
+			const mpf_class precise = probability.probability(x, 256);
+			ASSERT_LE(abs(precise - mpf_class(exact, 256)), mpf_class(exact, 256) * 1e-70);
+			if(exact == 0) {
+				ASSERT_EQ(probability.log_probability(x), -std::numeric_limits<double>::infinity());
+			} else {
+				ASSERT_NEAR(probability.log_probability(x), std::log(exact.get_d()), 1e-12);
+			}
+		}
+	}
+	{ // a probability below the smallest double
+		std::vector<unsigned int> many(1100, 1);
+		many[0] = 1000;
+		const IntervalPartition::PartitionProbability probability(many.data(), many.size());
+		ASSERT_EQ(probability.probability<double>(0), 0);
+		ASSERT_NEAR(probability.log_probability(0), -1099 * std::log(2.0) - std::log(1001.0), 1e-9);
+		ASSERT_NEAR(probability.log_probability(1), std::log(1100.0) - 1099 * std::log(2.0) - std::log(1001.0), 1e-9);
+	}
+}
+
+/**
+ * Checks that the error bound of the approximate engine encloses the exact count,
+ * and that the engine falls back to the exact count if the bound exceeds the tolerance.
+ */
+TEST_F(IntervalPartitionRandom, Approximate) {
+	auto check = [] (const unsigned int* const b, const size_t size, const unsigned long x, const double tolerance, const mp_bitcnt_t precision) {
+		const Z exact = IntervalPartition::number_of_interval_partitions(b, size, x, 1);
+		const IntervalPartition::Approximation approximation = IntervalPartition::approximate_number_of_interval_partitions(b, size, x, tolerance, precision);
+		if(approximation.exact) {
+			ASSERT_EQ(approximation.value, exact);
+			ASSERT_EQ(approximation.relativeError, 0);
+			return;
+		}
+		ASSERT_LE(approximation.relativeError, tolerance);
+		const mpf_class reference(exact, 1024);
+		ASSERT_LE(abs(approximation.value - reference), reference * approximation.relativeError) << "x = " << x;
+	};
+	for(size_t steps = 0; steps < 30; ++steps) {
+		next();
+		print();
+		const size_t maxdim = std::accumulate(bounds, bounds+bsize, static_cast<size_t>(0));
+		for(size_t x = 0; x <= maxdim+1; x += 1 + maxdim/10) {
+			check(bounds, bsize, x, 1e-20, 128);
+			check(bounds, bsize, x, 1e-6, 64);
+		}
+		ASSERT_TRUE(IntervalPartition::approximate_number_of_interval_partitions(bounds, bsize, z, 0).exact);
+	}
+	const unsigned int large[] = { 5641, 9314, 969, 8643, 6291, 6241, 8747, 7041, 1, 1 };
+	for(const unsigned long x : { 1UL, 999UL, 26433UL, 40000UL }) check(large, sizeof(large)/sizeof(unsigned int), x, 1e-20, 128);
+	ASSERT_FALSE(IntervalPartition::approximate_number_of_interval_partitions(large, sizeof(large)/sizeof(unsigned int), 26433, 1e-20, 128).exact);
+}